@@ -0,0 +1,588 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L   /* mkdtemp, rmdir */
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+#include "ir.h"
+#include "otimizador.h"
+#include "interpretador.h"
+#include "gerador_c.h"
+#include "tempo.h"
+#include "lote.h"
+#include "rpn.h"
+#include "tipos.h"
+
+#ifdef _WIN32
+#include <direct.h>
+#include <io.h>
+#define EXE  ".exe"
+#define remove_dir(d) _rmdir(d)
+#else
+#include <unistd.h>
+#define EXE  ""
+#define remove_dir(d) rmdir(d)
+#endif
+
+/* Arquivos temporários do AOT ficam num diretório novo dentro do temporário
+   do sistema, com nome único: duas execuções ao mesmo tempo não se pisam.
+   Devolve 0 se conseguiu criar. */
+static int cria_dir_tmp(char *buf, size_t n) {
+    const char *dir = getenv("TMPDIR");
+    if (!dir) dir = getenv("TEMP");
+#ifdef _WIN32
+    if (!dir) dir = ".";
+    snprintf(buf, n, "%s/mp_bench_XXXXXX", dir);
+    if (_mktemp_s(buf, strlen(buf) + 1) != 0) return 1;
+    return _mkdir(buf) != 0;
+#else
+    if (!dir) dir = "/tmp";
+    snprintf(buf, n, "%s/mp_bench_XXXXXX", dir);
+    return mkdtemp(buf) == NULL;
+#endif
+}
+
+/* Lê o arquivo inteiro (pra comparar as saídas); NULL se não abriu */
+static char *le_tudo(const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    long n = ftell(f);
+    rewind(f);
+    char *buf = malloc(n + 1);
+    if (!buf) { fclose(f); return NULL; }
+    buf[fread(buf, 1, n, f)] = '\0';
+    fclose(f);
+    return buf;
+}
+
+/* Quantas operações da IR são inteiras, reais e conversões (constantes e
+   phis não contam). Num laço só com integer, reais e conversões ficam em 0:
+   tudo roda nos opcodes _I do interpretador / em int64_t no AOT. */
+static void conta_tipos(const IRFuncao *f, int mix[3]) {
+    mix[0] = mix[1] = mix[2] = 0;
+    for (int b = 0; b < f->nblocos; b++) {
+        for (int k = 0; k < f->blocos[b].ninstrs; k++) {
+            const IRValor *v = &f->vals[f->blocos[b].instrs[k]];
+            if (v->op == IR_CONST || v->op == IR_PARAM || v->op == IR_PHI) continue;
+            if (v->op == IR_I2F || v->op == IR_TRUNC) mix[2]++;
+            else if ((v->op >= IR_EQ ? f->vals[v->a].tipo : v->tipo) == TIPO_INTEGER) mix[0]++;
+            else mix[1]++;
+        }
+    }
+}
+
+/* Roda o interpretador e devolve o menor tempo; a saída vai pra 'saida' */
+static double mede_interp(const Programa *prog, int otimizar, int repeticoes,
+                          double *preparo_ns, const char *saida, int mix[3]) {
+    double t0 = agora_ns();
+    IRFuncao *ir = ir_gera(prog);
+    if (otimizar) otimiza(ir, NULL, 0);
+    CodigoIR *c = interp_prepara(ir);
+    *preparo_ns = agora_ns() - t0;
+    conta_tipos(ir, mix);
+
+    Valor *vars = calloc(prog->nvars ? prog->nvars : 1, sizeof(Valor));
+    double melhor = -1.0;
+    for (int i = 0; i < repeticoes; i++) {
+        memset(vars, 0, (prog->nvars ? prog->nvars : 1) * sizeof(Valor)); /* estado inicial zerado */
+        double a = agora_ns();
+        interp_executa(c, vars);
+        double d = agora_ns() - a;
+        if (melhor < 0 || d < melhor) melhor = d;
+    }
+
+    FILE *out = fopen(saida, "w");
+    if (out) {
+        imprime_variaveis(prog, vars, out);
+        fclose(out);
+    }
+    free(vars);
+    interp_free(c);
+    ir_free(ir);
+    return melhor;
+}
+
+int bench_execucao(const Programa *prog, const char *arquivo, int repeticoes) {
+    char dir[512], arq_c[600], exe[600], out_o0[600], out_o2[600], out_aot[600];
+    if (cria_dir_tmp(dir, sizeof dir) != 0) {
+        fprintf(stderr, "Erro: não consegui criar o diretório temporário '%s'\n", dir);
+        return 1;
+    }
+    snprintf(arq_c, sizeof arq_c, "%s/aot.c", dir);
+    snprintf(exe, sizeof exe, "%s/aot" EXE, dir);
+    snprintf(out_o0, sizeof out_o0, "%s/o0.txt", dir);
+    snprintf(out_o2, sizeof out_o2, "%s/o2.txt", dir);
+    snprintf(out_aot, sizeof out_aot, "%s/aot.txt", dir);
+
+    if (repeticoes < 1) repeticoes = 1;
+
+    double prep_o0, prep_o2;
+    int mix[3];
+    double t_o0 = mede_interp(prog, 0, repeticoes, &prep_o0, out_o0, mix);
+    double t_o2 = mede_interp(prog, 1, repeticoes, &prep_o2, out_o2, mix);
+
+    /* AOT: o tempo de execução inclui criar o processo (fork/exec, sem
+       shell), então um programa com pouco laço sempre perde pro
+       interpretador aqui. O relatório avisa. */
+    double t0 = agora_ns();
+    int falhou = compila_c(prog, arquivo, arq_c, exe);
+    double prep_aot = agora_ns() - t0;
+    double t_aot = -1.0;
+    if (!falhou) {
+        char *argv[] = { exe, NULL };
+        if (roda_processo(argv, out_aot) != 0) falhou = 1;
+        for (int i = 0; i < repeticoes && !falhou; i++) {
+            double a = agora_ns();
+            if (roda_processo(argv, NULL) != 0) falhou = 1;
+            double d = agora_ns() - a;
+            if (t_aot < 0 || d < t_aot) t_aot = d;
+        }
+    }
+
+    printf("%-26s %14s %14s\n", "modo", "preparo(ms)", "execucao(ms)");
+    printf("%-26s %14.3f %14.3f\n", "interpretador -O0", prep_o0 / 1e6, t_o0 / 1e6);
+    printf("%-26s %14.3f %14.3f\n", "interpretador otimizado", prep_o2 / 1e6, t_o2 / 1e6);
+    if (!falhou) printf("%-26s %14.3f %14.3f\n", "AOT (C -O2)", prep_aot / 1e6, t_aot / 1e6);
+    else         printf("%-26s %14s %14s\n", "AOT (C -O2)", "falhou", "-");
+    if (!falhou) printf("(execucao do AOT inclui criar o processo e carregar o executavel)\n");
+    printf("IR otimizada: %d operacoes integer, %d real, %d conversoes\n", mix[0], mix[1], mix[2]);
+
+    /* Confere se todo mundo chegou no mesmo estado final */
+    char *s0 = le_tudo(out_o0), *s2 = le_tudo(out_o2), *sa = falhou ? NULL : le_tudo(out_aot);
+    int iguais = s0 && s2 && strcmp(s0, s2) == 0 && (falhou || (sa && strcmp(s0, sa) == 0));
+    printf("resultados: %s\n", iguais ? "iguais" : "DIFERENTES");
+    if (!iguais) {
+        printf("-- interpretador -O0:\n%s", s0 ? s0 : "");
+        printf("-- interpretador otimizado:\n%s", s2 ? s2 : "");
+        if (sa) printf("-- AOT:\n%s", sa);
+    }
+    free(s0);
+    free(s2);
+    free(sa);
+
+    remove(arq_c);
+    remove(exe);
+    remove(out_o0);
+    remove(out_o2);
+    remove(out_aot);
+    remove_dir(dir);
+    return iguais ? 0 : 1;
+}
+
+
+/* Mesmo valor nas duas execuções? Real compara por valor (0.0 == -0.0,
+   e NaN com NaN conta como igual) */
+static int mesmo_valor(Tipo t, Valor a, Valor b) {
+    if (t == TIPO_INTEGER) return a.i == b.i;
+    return a.f == b.f || (a.f != a.f && b.f != b.f);
+}
+
+/* Cria o lote e aplica os specs; NULL se algum spec não serviu */
+static Lote *monta_lote(const Programa *prog, int n, const char **specs, int nspecs) {
+    Lote *l = lote_novo(prog, n);
+    for (int s = 0; s < nspecs; s++) {
+        if (lote_varia(l, specs[s]) != 0) {
+            fprintf(stderr, "Erro: --varia '%s' invalido (use nome=inicio:passo com uma variavel declarada)\n", specs[s]);
+            lote_free(l);
+            return NULL;
+        }
+    }
+    return l;
+}
+
+static int confere_lote(const Programa *prog, const Lote *ref, const Lote *l, const char *modo) {
+    for (int v = 0; v < prog->nvars; v++) {
+        for (int i = 0; i < ref->n; i++) {
+            if (!mesmo_valor(prog->vars[v].tipo, ref->col[v][i], l->col[v][i])) {
+                printf("%s: instancia %d, variavel %s diferente\n", modo, i, prog->vars[v].nome);
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+int bench_lote(const Programa *prog, int n, const char **specs, int nspecs) {
+    if (n < 1) n = 1;
+
+    /* Referência: uma instância por vez no interpretador da IR otimizada.
+       As colunas do lote 'ref' guardam o estado inicial e recebem o final. */
+    Lote *ref = monta_lote(prog, n, specs, nspecs);
+    if (!ref) return 1;
+    IRFuncao *ir = ir_gera(prog);
+    otimiza(ir, NULL, 0);
+    CodigoIR *c = interp_prepara(ir);
+    Valor *vars = calloc(prog->nvars ? prog->nvars : 1, sizeof(Valor));
+
+    double a = agora_ns();
+    for (int i = 0; i < n; i++) {
+        for (int v = 0; v < prog->nvars; v++) vars[v] = ref->col[v][i];
+        interp_executa(c, vars);
+        for (int v = 0; v < prog->nvars; v++) ref->col[v][i] = vars[v];
+    }
+    double t_um = agora_ns() - a;
+    free(vars);
+    interp_free(c);
+    ir_free(ir);
+
+    Lote *esc = monta_lote(prog, n, specs, nspecs);
+    a = agora_ns();
+    lote_executa(esc, 0);
+    double t_esc = agora_ns() - a;
+
+    int avx2 = lote_tem_avx2();
+    Lote *vet = NULL;
+    double t_vet = -1.0;
+    if (avx2) {
+        vet = monta_lote(prog, n, specs, nspecs);
+        a = agora_ns();
+        lote_executa(vet, 1);
+        t_vet = agora_ns() - a;
+    }
+
+    printf("%d instancias (pedacos de %d)\n", n, LOTE_PEDACO);
+    printf("%-26s %14s %16s %10s\n", "modo", "tempo(ms)", "instancias/s", "ganho");
+    printf("%-26s %14.3f %16.0f %9.2fx\n", "uma por vez (IR -O)", t_um / 1e6, n / (t_um / 1e9), 1.0);
+    printf("%-26s %14.3f %16.0f %9.2fx\n", "lote escalar", t_esc / 1e6, n / (t_esc / 1e9), t_um / t_esc);
+    if (avx2) printf("%-26s %14.3f %16.0f %9.2fx\n", "lote AVX2", t_vet / 1e6, n / (t_vet / 1e9), t_um / t_vet);
+    else      printf("%-26s %14s %16s %10s\n", "lote AVX2", "sem suporte", "-", "-");
+
+    int iguais = confere_lote(prog, ref, esc, "lote escalar") &&
+                 (!vet || confere_lote(prog, ref, vet, "lote AVX2"));
+    printf("resultados: %s\n", iguais ? "iguais" : "DIFERENTES");
+
+    /* Amostra das primeiras instâncias */
+    Valor *linha = calloc(prog->nvars ? prog->nvars : 1, sizeof(Valor));
+    for (int i = 0; i < n && i < 3; i++) {
+        printf("-- instancia %d:\n", i);
+        for (int v = 0; v < prog->nvars; v++) linha[v] = esc->col[v][i];
+        imprime_variaveis(prog, linha, stdout);
+    }
+    free(linha);
+
+    lote_free(ref);
+    lote_free(esc);
+    lote_free(vet);
+    return iguais ? 0 : 1;
+}
+
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/* Percentil q (0..1) de v já ordenado */
+static double percentil(const double *v, int n, double q) {
+    if (n == 0) return 0.0;
+    int k = (int)(q * n + 0.999999) - 1;
+    if (k < 0) k = 0;
+    if (k >= n) k = n - 1;
+    return v[k];
+}
+
+static void linha_grupo(const char *nome, const Tarefa *t, int n, int grupo, double *lat) {
+    int conta[5] = {0}, m = 0;
+    for (int i = 0; i < n; i++) {
+        if (grupo >= 0 && t[i].grupo != grupo) continue;
+        conta[t[i].estado]++;
+        lat[m++] = t[i].fim_ns;
+    }
+    qsort(lat, m, sizeof(double), cmp_double);
+    printf("%-24s %7d %6d %5d %6d %5d %10.3f %10.3f %10.3f\n", nome, m,
+           conta[TAREFA_OK], conta[TAREFA_ERRO], conta[TAREFA_PASSOS], conta[TAREFA_MEMORIA],
+           percentil(lat, m, 0.50) / 1e6, percentil(lat, m, 0.99) / 1e6, m ? lat[m - 1] / 1e6 : 0.0);
+}
+
+int bench_escalona(const Programa **progs, const char **nomes, int nprogs,
+                   int ntarefas, const ConfigEscalonador *cfg) {
+    if (ntarefas < 1) ntarefas = 1;
+
+    /* Um código por programa, compartilhado pelas tarefas */
+    CodigoIR **cod = calloc(nprogs, sizeof(CodigoIR *));
+    for (int p = 0; p < nprogs; p++) {
+        IRFuncao *ir = ir_gera(progs[p]);
+        otimiza(ir, NULL, 0);
+        cod[p] = interp_prepara(ir);
+        ir_free(ir);
+    }
+
+    /* Referência: cada programa uma vez, sozinho, com o mesmo limite de passos */
+    Quadro *ref = calloc(nprogs, sizeof(Quadro));
+    int *ref_rc = calloc(nprogs, sizeof(int));
+    for (int p = 0; p < nprogs; p++) {
+        interp_quadro_inicia(cod[p], &ref[p]);
+        ref_rc[p] = interp_continua(cod[p], &ref[p], cfg->limite_passos > 0 ? cfg->limite_passos : (1LL << 62));
+        interp_quadro_libera(&ref[p]);
+    }
+
+    Tarefa *t = calloc(ntarefas, sizeof(Tarefa));
+    for (int i = 0; i < ntarefas; i++) tarefa_inicia(&t[i], i, i % nprogs, cod[i % nprogs]);
+
+    double total = escalona(t, ntarefas, cfg);
+
+    long long fatias = 0, roubos = 0;
+    for (int i = 0; i < ntarefas; i++) {
+        fatias += t[i].fatias;
+        roubos += t[i].roubos;
+    }
+    printf("%d tarefas, %d workers, fatia ", ntarefas, cfg->workers);
+    if (cfg->fatia > 0) printf("%lld passos", cfg->fatia);
+    else                printf("sem preempcao");
+    if (cfg->limite_passos > 0) printf(", limite %lld passos", cfg->limite_passos);
+    if (cfg->limite_mem > 0) printf(", limite %lu bytes", (unsigned long)cfg->limite_mem);
+    printf("\n");
+    printf("tempo total %.3f ms, %.0f tarefas/s, %lld fatias, %lld roubos\n",
+           total / 1e6, ntarefas / (total / 1e9), fatias, roubos);
+
+    printf("%-24s %7s %6s %5s %6s %5s %10s %10s %10s\n", "programa", "tarefas", "ok", "erro",
+           "passos", "mem", "p50(ms)", "p99(ms)", "max(ms)");
+    double *lat = calloc(ntarefas, sizeof(double));
+    for (int p = 0; p < nprogs; p++) linha_grupo(nomes[p], t, ntarefas, p, lat);
+    if (nprogs > 1) linha_grupo("todas", t, ntarefas, -1, lat);
+    free(lat);
+
+    /* Cada tarefa tem que terminar igual à execução sozinha */
+    int iguais = 1, erro_mostrado = 0;
+    for (int i = 0; i < ntarefas; i++) {
+        int p = t[i].grupo;
+        if (t[i].estado == TAREFA_ERRO && !erro_mostrado) {
+            fprintf(stderr, "%d:%d:divisao por zero (tarefa %d).\n",
+                    LINHA_COLUNA(progs[p]->fonte, t[i].q.erro_pos), t[i].id);
+            erro_mostrado = 1;
+        }
+        if (t[i].estado == TAREFA_MEMORIA) continue;
+        int esperado = ref_rc[p] == INTERP_TERMINOU ? TAREFA_OK
+                     : ref_rc[p] == INTERP_ERRO ? TAREFA_ERRO : TAREFA_PASSOS;
+        if ((int)t[i].estado != esperado ||
+            (esperado == TAREFA_OK &&
+             memcmp(t[i].q.vars, ref[p].vars, progs[p]->nvars * sizeof(Valor)) != 0)) {
+            if (iguais) printf("tarefa %d (%s) diferente da execucao sozinha\n", t[i].id, nomes[p]);
+            iguais = 0;
+        }
+    }
+    printf("resultados: %s\n", iguais ? "iguais" : "DIFERENTES");
+
+    for (int i = 0; i < ntarefas; i++) free(t[i].q.vars);
+    free(t);
+    for (int p = 0; p < nprogs; p++) {
+        free(ref[p].vars);
+        interp_free(cod[p]);
+    }
+    free(ref);
+    free(ref_rc);
+    free(cod);
+    return iguais ? 0 : 1;
+}
+
+
+/* ---- Expressões: árvore x pós-fixa ---- */
+
+#define EXPR_POR_PROGRAMA 50000
+
+static unsigned long long sorteio = 88172645463325252ULL;
+
+static unsigned sorteia(unsigned n) {
+    sorteio ^= sorteio << 13;
+    sorteio ^= sorteio >> 7;
+    sorteio ^= sorteio << 17;
+    return (unsigned)(sorteio % n);
+}
+
+static void folha(char **p, int divisor) {
+    static const char *vars[] = { "a", "b", "c", "d", "x", "y" };
+    unsigned r = sorteia(10);
+    if (!divisor && r < 6) *p += sprintf(*p, "%s", vars[sorteia(6)]);
+    else if (r < 8)        *p += sprintf(*p, "%u", 1 + sorteia(99));
+    else                   *p += sprintf(*p, "%u.%02u", 1 + sorteia(9), sorteia(100));
+}
+
+/* Expressão aleatória com até 'prof' níveis. Divisão só por literal não
+   nulo, e o sinal unário vai entre parênteses (a gramática só aceita o
+   sinal no começo da expressão simples). */
+static void gera_expr(char **p, int prof) {
+    static const char ops[] = "+-*/";
+    unsigned r = sorteia(10);
+    if (prof == 0 || r < 3) {
+        folha(p, 0);
+    } else if (r == 3) {
+        *p += sprintf(*p, "(-");
+        gera_expr(p, prof - 1);
+        *p += sprintf(*p, ")");
+    } else {
+        char op = ops[sorteia(4)];
+        *p += sprintf(*p, "(");
+        gera_expr(p, prof - 1);
+        *p += sprintf(*p, " %c ", op);
+        if (op == '/') folha(p, 1);
+        else gera_expr(p, prof - 1);
+        *p += sprintf(*p, ")");
+    }
+}
+
+static char *gera_programa(int n) {
+    static const char *rels[] = { "=", "<>", "<", "<=", ">", ">=" };
+    char *src = malloc((size_t)n * 400 + 256);
+    if (!src) { perror("malloc"); exit(1); }
+    char *p = src;
+    p += sprintf(p, "program gerado;\nvar\n    a, b, c, d: integer;\n    x, y: real;\nbegin\n");
+    for (int i = 0; i < n; i++) {
+        p += sprintf(p, "    a := ");
+        gera_expr(&p, 4);
+        if (sorteia(8) == 0) {
+            p += sprintf(p, " %s ", rels[sorteia(6)]);
+            gera_expr(&p, 2);
+        }
+        p += sprintf(p, ";\n");
+    }
+    sprintf(p, "end.\n");
+    return src;
+}
+
+#define U(x) ((unsigned long long)(x))
+
+static Fonte *fonte_gerada;   /* do programa sendo avaliado, só pra mensagem de erro */
+
+/* O jeito de sempre: recursão pelos ponteiros, convertendo pelo tipo dos filhos */
+static Valor avalia_ast(const AST *e, const Valor *vars) {
+    Valor r, a, b;
+    switch (e->kind) {
+        case AST_NUM:
+            return e->num;
+        case AST_VAR:
+            return vars[e->var];
+        case AST_NEG:
+            a = avalia_ast(e->left, vars);
+            if (e->tipo == TIPO_INTEGER) r.i = (long long)(0 - U(a.i));
+            else                         r.f = -a.f;
+            return r;
+        default:
+            break;
+    }
+    a = avalia_ast(e->left, vars);
+    b = avalia_ast(e->right, vars);
+    Tipo t = tipo_comum(e->left->tipo, e->right->tipo);
+    if (t == TIPO_REAL) {
+        if (e->left->tipo == TIPO_INTEGER) a.f = (double)a.i;
+        if (e->right->tipo == TIPO_INTEGER) b.f = (double)b.i;
+        switch (e->kind) {
+            case AST_ADD: r.f = a.f + b.f; break;
+            case AST_SUB: r.f = a.f - b.f; break;
+            case AST_MUL: r.f = a.f * b.f; break;
+            case AST_DIV: r.f = a.f / b.f; break;
+            case AST_EQ:  r.i = a.f == b.f; break;
+            case AST_NE:  r.i = a.f != b.f; break;
+            case AST_LT:  r.i = a.f <  b.f; break;
+            case AST_LE:  r.i = a.f <= b.f; break;
+            case AST_GT:  r.i = a.f >  b.f; break;
+            default:      r.i = a.f >= b.f; break;
+        }
+    } else {
+        switch (e->kind) {
+            case AST_ADD: r.i = (long long)(U(a.i) + U(b.i)); break;
+            case AST_SUB: r.i = (long long)(U(a.i) - U(b.i)); break;
+            case AST_MUL: r.i = (long long)(U(a.i) * U(b.i)); break;
+            case AST_DIV:
+                if (b.i == 0) {
+                    fprintf(stderr, "%d:%d:divisao por zero.\n", LINHA_COLUNA(fonte_gerada, e->pos));
+                    exit(EXIT_FAILURE);
+                }
+                r.i = div_inteira(a.i, b.i);
+                break;
+            case AST_EQ:  r.i = a.i == b.i; break;
+            case AST_NE:  r.i = a.i != b.i; break;
+            case AST_LT:  r.i = a.i <  b.i; break;
+            case AST_LE:  r.i = a.i <= b.i; break;
+            case AST_GT:  r.i = a.i >  b.i; break;
+            default:      r.i = a.i >= b.i; break;
+        }
+    }
+    return r;
+}
+
+#undef U
+
+static long long conta_nos(const AST *e) {
+    return e ? 1 + conta_nos(e->left) + conta_nos(e->right) : 0;
+}
+
+int bench_expressoes(int n) {
+    if (n < 1) n = 1;
+    /* a, b, c, d integer; x, y real (na ordem da declaração) */
+    Valor vars[6];
+    vars[0].i = 3; vars[1].i = -5; vars[2].i = 7; vars[3].i = 11;
+    vars[4].f = 1.5; vars[5].f = -2.25;
+
+    double t_ast = 0.0, t_rpn = 0.0;
+    long long nos_ast = 0, nos_rpn = 0, ctes = 0, diferentes = 0;
+    const int voltas = 3;   /* vale a menor de 3 passadas em cada lote */
+
+    for (int feitas = 0; feitas < n; feitas += EXPR_POR_PROGRAMA) {
+        int m = n - feitas < EXPR_POR_PROGRAMA ? n - feitas : EXPR_POR_PROGRAMA;
+        char *src = gera_programa(m);
+        TokenVec tv = tokenize_to_vector(src);
+        Programa *prog = parse_program_rpn(&tv);
+        fonte_gerada = prog->fonte;
+
+        const AST **arv = malloc(m * sizeof(AST *));
+        RpnExpr *pos = malloc(m * sizeof(RpnExpr));
+        Valor *res_ast = malloc(m * sizeof(Valor)), *res_rpn = malloc(m * sizeof(Valor));
+        int k = 0;
+        for (const Comando *c = prog->corpo->corpo; c; c = c->prox, k++) {
+            arv[k] = c->expr;
+            pos[k] = c->rpn;
+            nos_ast += conta_nos(c->expr);
+        }
+        nos_rpn += prog->rpn.nnos;
+        ctes += prog->rpn.nctes;
+
+        double melhor_ast = -1.0, melhor_rpn = -1.0;
+        for (int v = 0; v < voltas; v++) {
+            double a = agora_ns();
+            for (int i = 0; i < m; i++) res_ast[i] = avalia_ast(arv[i], vars);
+            double d = agora_ns() - a;
+            if (melhor_ast < 0 || d < melhor_ast) melhor_ast = d;
+
+            a = agora_ns();
+            for (int i = 0; i < m; i++)
+                if (rpn_avalia(&prog->rpn, pos[i], vars, &res_rpn[i])) {
+                    fprintf(stderr, "%d:%d:divisao por zero.\n", LINHA_COLUNA(prog->fonte, arv[i]->pos));
+                    exit(EXIT_FAILURE);
+                }
+            d = agora_ns() - a;
+            if (melhor_rpn < 0 || d < melhor_rpn) melhor_rpn = d;
+        }
+        t_ast += melhor_ast;
+        t_rpn += melhor_rpn;
+
+        for (int i = 0; i < m; i++) {
+            Tipo t = arv[i]->tipo;
+            if (t != rpn_tipo(&prog->rpn, pos[i]) ||
+                (t == TIPO_INTEGER ? res_ast[i].i != res_rpn[i].i
+                                   : memcmp(&res_ast[i].f, &res_rpn[i].f, sizeof(double)) != 0))
+                diferentes++;
+        }
+
+        free(arv);
+        free(pos);
+        free(res_ast);
+        free(res_rpn);
+        programa_free(prog);
+        tv_free(&tv);
+        free(src);
+    }
+
+    double bytes_rpn = (double)(nos_rpn * sizeof(RpnNo) + ctes * sizeof(Valor)) / nos_rpn;
+    printf("%d expressoes, %lld nos\n", n, nos_ast);
+    printf("%-22s %12s %14s %14s\n", "representacao", "bytes/no", "tempo(ms)", "ns/expressao");
+    printf("%-22s %12lu %14.3f %14.1f\n", "arvore (AST)", (unsigned long)sizeof(AST), t_ast / 1e6, t_ast / n);
+    printf("%-22s %12.1f %14.3f %14.1f\n", "pos-fixa (RPN)", bytes_rpn, t_rpn / 1e6, t_rpn / n);
+    printf("AST: %lu bytes por no + cabecalho do malloc, cada no alocado separado\n", (unsigned long)sizeof(AST));
+    printf("RPN: %lu bytes por no + %lu por constante, tudo em dois vetores contiguos\n",
+           (unsigned long)sizeof(RpnNo), (unsigned long)sizeof(Valor));
+    printf("ganho: %.2fx no tempo, %.1fx na memoria\n", t_ast / t_rpn, sizeof(AST) / bytes_rpn);
+    printf("resultados: %s\n", diferentes ? "DIFERENTES" : "iguais");
+    return diferentes ? 1 : 0;
+}
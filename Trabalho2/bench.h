@@ -0,0 +1,30 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "sintatico.h"
+#include "escalonador.h"
+
+/* Compara os modos de execução no mesmo programa: interpretador da IR
+   sem e com otimização, e o executável gerado pelo backend AOT.
+   Cada modo roda 'repeticoes' vezes e vale o menor tempo.
+   Devolve 0 se todos os modos chegaram no mesmo resultado. */
+int bench_execucao(const Programa *prog, const char *arquivo, int repeticoes);
+
+/* Roda n instâncias do programa (estado inicial dado pelos "nome=inicio:passo"
+   em specs) de três jeitos: uma por vez no interpretador otimizado, em lote
+   com laços escalares e em lote com AVX2. Devolve 0 se os três bateram. */
+int bench_lote(const Programa *prog, int n, const char **specs, int nspecs);
+
+/* Roda ntarefas tarefas no escalonador, alternando entre os nprogs
+   programas (tarefa i usa o programa i % nprogs). Mostra vazão e latência
+   (p50/p99/máx. de cada programa) e confere o resultado de cada tarefa com
+   o interpretador. Devolve 0 se todas bateram. */
+int bench_escalona(const Programa **progs, const char **nomes, int nprogs,
+                   int ntarefas, const ConfigEscalonador *cfg);
+
+/* Gera n expressões aleatórias (em programas de até 50 mil atribuições),
+   e avalia todas andando na árvore (AST) e no vetor pós-fixo (RPN).
+   Mostra tempo e memória por nó dos dois jeitos. Devolve 0 se bateram. */
+int bench_expressoes(int n);
+
+#endif
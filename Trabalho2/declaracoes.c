@@ -1,174 +1,219 @@
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-
-#include "declaracoes.h"
-#include "lexico.h"     
-#include "sintatico.h"  
-
-/* Aqui fica a lógica pra lidar com as variáveis e tipos.
-   É a parte que entende "var a, b: integer;" e afins.
-*/
-
-/* --- Utilitários pra facilitar a vida --- */
-
-/* Dá uma espiada no token atual sem consumir ele. Se acabou, devolve o último. */
-const Token *cur(Parser *p){
-    if (!p) return NULL;
-    if (p->i < 0) return NULL;
-    if (p->i >= p->n) return &p->toks[p->n-1]; /* Proteção contra estouro de array */
-    return &p->toks[p->i];
-}
-
-/* Só avança o índice pro próximo. */
-void advance(Parser *p){
-    if (p->i < p->n - 1) p->i++;
-}
-
-/* Verifica se o token é o que a gente quer. 
-   Se for, beleza, passa. Se não, derruba o programa com erro.
-*/
-void match(Parser *p, int expected){
-    const Token *t = cur(p);
-    if (!t) {
-        fprintf(stderr, "0:fim de arquivo não esperado.\n");
-        exit(EXIT_FAILURE);
-    }
-    if (t->type == expected){
-        /* Bateu! Segue o baile. */
-        advance(p);
-        return;
-    } else {
-        if (t->type == END_FILE) {
-            fprintf(stderr, "%d:fim de arquivo não esperado.\n", t->line);
-            exit(EXIT_FAILURE);
-        } else {
-            /* Veio coisa errada na linha tal */
-            const char *lex = t->lexeme ? t->lexeme : token_name(t->type);
-            fprintf(stderr, "%d:token nao esperado [%s].\n", t->line, lex);
-            exit(EXIT_FAILURE);
-        }
-    }
-}
-
-void declaracao_de_variaveis(Parser *p);
-void lista_identificadores(Parser *p);
-void tipo(Parser *p);
-
-/* Processa o bloco de variáveis.
-   Lembrando: 'var' é opcional. Se não tiver, a gente só sai de fininho.
-   Se tiver, tem que ler as declarações até achar algo que não seja variável (geralmente o begin).
-*/
-void parte_de_declaracoes_de_variaveis(Parser *p){
-    const Token *t = cur(p);
-    if (!t) return;
-
-    /* Se não começa com 'var', não tem nada pra ver aqui. */
-    if (t->type != VAR_TOK){
-        return;
-    }
-
-    printf("<parte_de_declaracoes_de_variaveis> ::= var <declaracao_de_variaveis> { ; <declaracao_de_variaveis> } ;\n");
-    match(p, VAR_TOK);
-
-    /* Obrigatório ter pelo menos uma declaração depois do 'var' */
-    declaracao_de_variaveis(p);
-
-    /* Loop pra pegar declarações extras separadas por ponto e vírgula */
-    while (cur(p) && cur(p)->type == SEMICOLON){
-        match(p, SEMICOLON);
-        
-        /* Cuidado aqui: O ';' pode ser só o separador final antes do 'begin'.
-           Se o próximo token for o início do programa, paramos de ler variáveis.
-        */
-        if (cur(p)->type == BEGIN_TOK) {
-            break;
-        }
-        
-        if (cur(p)->type == ID) {
-            declaracao_de_variaveis(p);
-        } else {
-            /* Tinha um ';' mas veio lixo depois */
-            const Token *errt = cur(p);
-            if (errt->type == END_FILE) {
-                fprintf(stderr, "%d:fim de arquivo não esperado.\n", errt->line);
-                exit(EXIT_FAILURE);
-            } else {
-                const char *lex = errt->lexeme ? errt->lexeme : token_name(errt->type);
-                fprintf(stderr, "%d:token nao esperado [%s].\n", errt->line, lex);
-                exit(EXIT_FAILURE);
-            }
-        }
-    }
-}
-
-/* Exemplo: x, y, z : integer */
-void declaracao_de_variaveis(Parser *p){
-    printf("<declaracao_de_variaveis> ::= <lista_de_identificadores> : <tipo>\n");
-    lista_identificadores(p);
-    match(p, COLON); /* Os dois pontos são cruciais */
-    tipo(p);
-}
-
-/* Pega a lista de nomes: id, id, id... */
-void lista_identificadores(Parser *p){
-    printf("<lista_de_identificadores> ::= <identificador> { , <identificador> }\n");
-    const Token *t = cur(p);
-    if (!t) {
-        fprintf(stderr, "0:fim de arquivo não esperado.\n");
-        exit(EXIT_FAILURE);
-    }
-    
-    /* Tem que começar com um ID */
-    if (t->type != ID){
-        if (t->type == END_FILE) {
-            fprintf(stderr, "%d:fim de arquivo não esperado.\n", t->line);
-        } else {
-            const char *lex = t->lexeme ? t->lexeme : token_name(t->type);
-            fprintf(stderr, "%d:token nao esperado [%s].\n", t->line, lex);
-        }
-        exit(EXIT_FAILURE);
-    }
-    match(p, ID);
-
-    /* Consome vírgula e o próximo ID repetidamente */
-    while (cur(p) && cur(p)->type == COMMA){
-        match(p, COMMA);
-        if (cur(p)->type != ID){
-            /* Vírgula sem nome depois é erro de sintaxe */
-            const Token *errt = cur(p);
-            if (errt->type == END_FILE) {
-                fprintf(stderr, "%d:fim de arquivo não esperado.\n", errt->line);
-            } else {
-                const char *lex = errt->lexeme ? errt->lexeme : token_name(errt->type);
-                fprintf(stderr, "%d:token nao esperado [%s].\n", errt->line, lex);
-            }
-            exit(EXIT_FAILURE);
-        }
-        match(p, ID);
-    }
-}
-
-/* Valida se é integer ou real */
-void tipo(Parser *p){
-    printf("<tipo> ::= integer | real\n");
-    const Token *t = cur(p);
-    if (!t) {
-        fprintf(stderr, "0:fim de arquivo não esperado.\n");
-        exit(EXIT_FAILURE);
-    }
-    if (t->type == INTEGER_TOK){
-        match(p, INTEGER_TOK);
-    } else if (t->type == REAL_TOK){
-        match(p, REAL_TOK);
-    } else {
-        /* Tipo desconhecido */
-        if (t->type == END_FILE) {
-            fprintf(stderr, "%d:fim de arquivo não esperado.\n", t->line);
-        } else {
-            const char *lex = t->lexeme ? t->lexeme : token_name(t->type);
-            fprintf(stderr, "%d:token nao esperado [%s].\n", t->line, lex);
-        }
-        exit(EXIT_FAILURE);
-    }
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "declaracoes.h"
+#include "lexico.h"     
+#include "sintatico.h"  
+
+/* Aqui fica a lógica pra lidar com as variáveis e tipos.
+   É a parte que entende "var a, b: integer;" e afins.
+*/
+
+/* --- Utilitários pra facilitar a vida --- */
+
+/* Dá uma espiada no token atual sem consumir ele. Se acabou, devolve o último. */
+const Token *cur(Parser *p){
+    if (!p) return NULL;
+    if (p->i < 0) return NULL;
+    if (p->i >= p->n) return &p->toks[p->n-1]; /* Proteção contra estouro de array */
+    return &p->toks[p->i];
+}
+
+/* Só avança o índice pro próximo. */
+void advance(Parser *p){
+    if (p->i < p->n - 1) p->i++;
+}
+
+/* Verifica se o token é o que a gente quer. 
+   Se for, beleza, passa. Se não, derruba o programa com erro.
+*/
+void match(Parser *p, int expected){
+    const Token *t = cur(p);
+    if (!t) {
+        fprintf(stderr, "0:0:fim de arquivo não esperado.\n");
+        exit(EXIT_FAILURE);
+    }
+    if (t->type == expected){
+        /* Bateu! Segue o baile. */
+        advance(p);
+        return;
+    } else {
+        if (t->type == END_FILE) {
+            fprintf(stderr, "%d:%d:fim de arquivo não esperado.\n", LINHA_COLUNA(p->prog->fonte, t->pos));
+            exit(EXIT_FAILURE);
+        } else {
+            /* Veio coisa errada na linha tal */
+            const char *lex = t->lexeme ? t->lexeme : token_name(t->type);
+            fprintf(stderr, "%d:%d:token nao esperado [%s].\n", LINHA_COLUNA(p->prog->fonte, t->pos), lex);
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+void declaracao_de_variaveis(Parser *p);
+void lista_identificadores(Parser *p);
+Tipo tipo(Parser *p);
+
+/* --- Tabela de variáveis ---
+   Guarda nome e tipo de cada variável declarada, na ordem da declaração.
+   O índice na tabela é o que o resto do compilador usa pra se referir à variável.
+*/
+
+int busca_variavel(const Programa *prog, const char *nome){
+    for (int i = 0; i < prog->nvars; i++) {
+        if (strcmp(prog->vars[i].nome, nome) == 0) return i;
+    }
+    return -1;
+}
+
+/* Registra o ID do token na tabela. O tipo é preenchido depois, quando
+   a gente chega no ": integer" / ": real" da declaração. */
+int declara_variavel(Parser *p, const Token *t){
+    Programa *prog = p->prog;
+    if (busca_variavel(prog, t->lexeme) >= 0) {
+        fprintf(stderr, "%d:%d:identificador ja declarado [%s].\n", LINHA_COLUNA(p->prog->fonte, t->pos), t->lexeme);
+        exit(EXIT_FAILURE);
+    }
+    if (prog->nvars == prog->capvars) {
+        int cap = prog->capvars ? prog->capvars * 2 : 8;
+        Variavel *nv = realloc(prog->vars, cap * sizeof(Variavel));
+        if (!nv) { perror("realloc"); exit(1); }
+        prog->vars = nv; prog->capvars = cap;
+    }
+    Variavel *v = &prog->vars[prog->nvars];
+    v->nome = malloc(strlen(t->lexeme) + 1);
+    if (!v->nome) { perror("malloc"); exit(1); }
+    strcpy(v->nome, t->lexeme);
+    v->tipo = TIPO_INTEGER;
+    v->pos = t->pos;
+    return prog->nvars++;
+}
+
+/* Processa o bloco de variáveis.
+   Lembrando: 'var' é opcional. Se não tiver, a gente só sai de fininho.
+   Se tiver, tem que ler as declarações até achar algo que não seja variável (geralmente o begin).
+*/
+void parte_de_declaracoes_de_variaveis(Parser *p){
+    const Token *t = cur(p);
+    if (!t) return;
+
+    /* Se não começa com 'var', não tem nada pra ver aqui. */
+    if (t->type != VAR_TOK){
+        return;
+    }
+
+    DERIVACAO("<parte_de_declaracoes_de_variaveis> ::= var <declaracao_de_variaveis> { ; <declaracao_de_variaveis> } ;\n");
+    match(p, VAR_TOK);
+
+    /* Obrigatório ter pelo menos uma declaração depois do 'var' */
+    declaracao_de_variaveis(p);
+
+    /* Loop pra pegar declarações extras separadas por ponto e vírgula */
+    while (cur(p) && cur(p)->type == SEMICOLON){
+        match(p, SEMICOLON);
+        
+        /* Cuidado aqui: O ';' pode ser só o separador final antes do 'begin'.
+           Se o próximo token for o início do programa, paramos de ler variáveis.
+        */
+        if (cur(p)->type == BEGIN_TOK) {
+            break;
+        }
+        
+        if (cur(p)->type == ID) {
+            declaracao_de_variaveis(p);
+        } else {
+            /* Tinha um ';' mas veio lixo depois */
+            const Token *errt = cur(p);
+            if (errt->type == END_FILE) {
+                fprintf(stderr, "%d:%d:fim de arquivo não esperado.\n", LINHA_COLUNA(p->prog->fonte, errt->pos));
+                exit(EXIT_FAILURE);
+            } else {
+                const char *lex = errt->lexeme ? errt->lexeme : token_name(errt->type);
+                fprintf(stderr, "%d:%d:token nao esperado [%s].\n", LINHA_COLUNA(p->prog->fonte, errt->pos), lex);
+                exit(EXIT_FAILURE);
+            }
+        }
+    }
+}
+
+/* Exemplo: x, y, z : integer */
+void declaracao_de_variaveis(Parser *p){
+    DERIVACAO("<declaracao_de_variaveis> ::= <lista_de_identificadores> : <tipo>\n");
+    int primeira = p->prog->nvars;
+    lista_identificadores(p);
+    match(p, COLON); /* Os dois pontos são cruciais */
+    Tipo t = tipo(p);
+
+    /* Agora que sabemos o tipo, aplica em todo mundo da lista */
+    for (int i = primeira; i < p->prog->nvars; i++) {
+        p->prog->vars[i].tipo = t;
+    }
+}
+
+/* Pega a lista de nomes: id, id, id... */
+void lista_identificadores(Parser *p){
+    DERIVACAO("<lista_de_identificadores> ::= <identificador> { , <identificador> }\n");
+    const Token *t = cur(p);
+    if (!t) {
+        fprintf(stderr, "0:0:fim de arquivo não esperado.\n");
+        exit(EXIT_FAILURE);
+    }
+    
+    /* Tem que começar com um ID */
+    if (t->type != ID){
+        if (t->type == END_FILE) {
+            fprintf(stderr, "%d:%d:fim de arquivo não esperado.\n", LINHA_COLUNA(p->prog->fonte, t->pos));
+        } else {
+            const char *lex = t->lexeme ? t->lexeme : token_name(t->type);
+            fprintf(stderr, "%d:%d:token nao esperado [%s].\n", LINHA_COLUNA(p->prog->fonte, t->pos), lex);
+        }
+        exit(EXIT_FAILURE);
+    }
+    declara_variavel(p, t);
+    match(p, ID);
+
+    /* Consome vírgula e o próximo ID repetidamente */
+    while (cur(p) && cur(p)->type == COMMA){
+        match(p, COMMA);
+        if (cur(p)->type != ID){
+            /* Vírgula sem nome depois é erro de sintaxe */
+            const Token *errt = cur(p);
+            if (errt->type == END_FILE) {
+                fprintf(stderr, "%d:%d:fim de arquivo não esperado.\n", LINHA_COLUNA(p->prog->fonte, errt->pos));
+            } else {
+                const char *lex = errt->lexeme ? errt->lexeme : token_name(errt->type);
+                fprintf(stderr, "%d:%d:token nao esperado [%s].\n", LINHA_COLUNA(p->prog->fonte, errt->pos), lex);
+            }
+            exit(EXIT_FAILURE);
+        }
+        declara_variavel(p, cur(p));
+        match(p, ID);
+    }
+}
+
+/* Valida se é integer ou real e devolve qual foi */
+Tipo tipo(Parser *p){
+    DERIVACAO("<tipo> ::= integer | real\n");
+    const Token *t = cur(p);
+    if (!t) {
+        fprintf(stderr, "0:0:fim de arquivo não esperado.\n");
+        exit(EXIT_FAILURE);
+    }
+    if (t->type == INTEGER_TOK){
+        match(p, INTEGER_TOK);
+        return TIPO_INTEGER;
+    } else if (t->type == REAL_TOK){
+        match(p, REAL_TOK);
+        return TIPO_REAL;
+    } else {
+        /* Tipo desconhecido */
+        if (t->type == END_FILE) {
+            fprintf(stderr, "%d:%d:fim de arquivo não esperado.\n", LINHA_COLUNA(p->prog->fonte, t->pos));
+        } else {
+            const char *lex = t->lexeme ? t->lexeme : token_name(t->type);
+            fprintf(stderr, "%d:%d:token nao esperado [%s].\n", LINHA_COLUNA(p->prog->fonte, t->pos), lex);
+        }
+        exit(EXIT_FAILURE);
+    }
 }
\ No newline at end of file
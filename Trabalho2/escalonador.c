@@ -0,0 +1,282 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L   /* sysconf */
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "escalonador.h"
+#include "tempo.h"
+
+/* Threads: pthreads, ou a API do Windows */
+#ifdef _WIN32
+#include <windows.h>
+typedef CRITICAL_SECTION Trava;
+typedef CONDITION_VARIABLE Sinal;
+typedef HANDLE Fio;
+#define trava_inicia(t)  InitializeCriticalSection(t)
+#define trava_fecha(t)   DeleteCriticalSection(t)
+#define trava(t)         EnterCriticalSection(t)
+#define destrava(t)      LeaveCriticalSection(t)
+#define sinal_inicia(s)  InitializeConditionVariable(s)
+#define sinal_fecha(s)   ((void)(s))
+#define espera(s, t)     SleepConditionVariableCS((s), (t), INFINITE)
+#define acorda_todos(s)  WakeAllConditionVariable(s)
+#define FIO_FUNC(nome)   static DWORD WINAPI nome(LPVOID arg)
+#define FIO_FIM          return 0
+#else
+#include <pthread.h>
+#include <unistd.h>
+typedef pthread_mutex_t Trava;
+typedef pthread_cond_t Sinal;
+typedef pthread_t Fio;
+#define trava_inicia(t)  pthread_mutex_init((t), NULL)
+#define trava_fecha(t)   pthread_mutex_destroy(t)
+#define trava(t)         pthread_mutex_lock(t)
+#define destrava(t)      pthread_mutex_unlock(t)
+#define sinal_inicia(s)  pthread_cond_init((s), NULL)
+#define sinal_fecha(s)   pthread_cond_destroy(s)
+#define espera(s, t)     pthread_cond_wait((s), (t))
+#define acorda_todos(s)  pthread_cond_broadcast(s)
+#define FIO_FUNC(nome)   static void *nome(void *arg)
+#define FIO_FIM          return NULL
+#endif
+
+#define SEM_LIMITE (1LL << 62)
+
+static void *aloca(size_t n) {
+    void *m = calloc(1, n ? n : 1);
+    if (!m) { perror("calloc"); exit(1); }
+    return m;
+}
+
+int escalonador_cpus(void) {
+#ifdef _WIN32
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    return (int)si.dwNumberOfProcessors;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+#endif
+}
+
+/* Fila de um worker: anel com trava. Cabe todas as tarefas, porque cada
+   uma está em no máximo uma fila de cada vez. */
+typedef struct {
+    Trava    trava;
+    Tarefa **anel;
+    int      ini, n, cap;
+} Fila;
+
+static void poe_fim(Fila *f, Tarefa *t) {
+    trava(&f->trava);
+    f->anel[(f->ini + f->n) % f->cap] = t;
+    f->n++;
+    destrava(&f->trava);
+}
+
+static Tarefa *tira_frente(Fila *f) {
+    Tarefa *t = NULL;
+    trava(&f->trava);
+    if (f->n > 0) {
+        t = f->anel[f->ini];
+        f->ini = (f->ini + 1) % f->cap;
+        f->n--;
+    }
+    destrava(&f->trava);
+    return t;
+}
+
+static Tarefa *tira_fim(Fila *f) {
+    Tarefa *t = NULL;
+    trava(&f->trava);
+    if (f->n > 0) {
+        f->n--;
+        t = f->anel[(f->ini + f->n) % f->cap];
+    }
+    destrava(&f->trava);
+    return t;
+}
+
+/* Worker sem nada pra fazer dorme em 'novidade' em vez de ficar girando.
+   'versao' sobe a cada tarefa devolvida pra uma fila e a cada tarefa que
+   termina: quem olhou as filas vazias na versão v só dorme se ela ainda é v
+   (senão alguém pôs tarefa depois que ele olhou e o aviso se perderia). */
+typedef struct {
+    const ConfigEscalonador *cfg;
+    Fila  *filas;
+    int    nfilas;
+    Trava  trava;       /* protege 'restantes', 'versao' e 'dormindo' */
+    Sinal  novidade;
+    int    restantes;   /* tarefas que ainda não terminaram */
+    long   versao;
+    int    dormindo;
+    double t0;
+} Escalonador;
+
+/* Alguma coisa mudou: acorda quem está dormindo pra olhar de novo */
+static void avisa(Escalonador *e, int terminou) {
+    trava(&e->trava);
+    if (terminou) e->restantes--;
+    e->versao++;
+    if (e->dormindo > 0) acorda_todos(&e->novidade);
+    destrava(&e->trava);
+}
+
+typedef struct {
+    Escalonador *e;
+    int          eu;
+} Worker;
+
+void tarefa_inicia(Tarefa *t, int id, int grupo, const CodigoIR *c) {
+    memset(t, 0, sizeof *t);
+    t->id = id;
+    t->grupo = grupo;
+    t->c = c;
+    t->estado = TAREFA_PRONTA;
+}
+
+static void termina(Escalonador *e, Tarefa *t, EstadoTarefa estado) {
+    t->estado = estado;
+    t->fim_ns = agora_ns() - e->t0;
+    interp_quadro_libera(&t->q);
+    avisa(e, 1);
+}
+
+/* Uma fatia da tarefa. Devolve 1 se ela ainda tem o que rodar. */
+static int roda_fatia(Escalonador *e, Tarefa *t) {
+    const ConfigEscalonador *cfg = e->cfg;
+
+    if (t->fatias++ == 0) {
+        if (cfg->limite_mem && interp_quadro_bytes(t->c) > cfg->limite_mem) {
+            termina(e, t, TAREFA_MEMORIA);
+            return 0;
+        }
+        interp_quadro_inicia(t->c, &t->q);
+    }
+
+    long long orcamento = cfg->fatia > 0 ? cfg->fatia : SEM_LIMITE;
+    if (cfg->limite_passos > 0 && cfg->limite_passos - t->q.passos < orcamento)
+        orcamento = cfg->limite_passos - t->q.passos;
+
+    switch (interp_continua(t->c, &t->q, orcamento)) {
+        case INTERP_TERMINOU:
+            termina(e, t, TAREFA_OK);
+            return 0;
+        case INTERP_ERRO:
+            termina(e, t, TAREFA_ERRO);
+            return 0;
+        default:
+            if (cfg->limite_passos > 0 && t->q.passos >= cfg->limite_passos) {
+                termina(e, t, TAREFA_PASSOS);
+                return 0;
+            }
+            return 1;
+    }
+}
+
+/* Rouba do fim da fila de outro worker, começando pelo vizinho */
+static Tarefa *rouba(Escalonador *e, int eu) {
+    for (int k = 1; k < e->nfilas; k++) {
+        Tarefa *t = tira_fim(&e->filas[(eu + k) % e->nfilas]);
+        if (t) {
+            t->roubos++;
+            return t;
+        }
+    }
+    return NULL;
+}
+
+FIO_FUNC(trabalha) {
+    Worker *w = arg;
+    Escalonador *e = w->e;
+    Fila *minha = &e->filas[w->eu];
+
+    for (;;) {
+        trava(&e->trava);
+        long visto = e->versao;
+        destrava(&e->trava);
+
+        Tarefa *t = tira_frente(minha);
+        if (!t) t = rouba(e, w->eu);
+        if (!t) {
+            /* As que faltam estão rodando em outro worker: dorme até uma
+               voltar pra fila ou terminar */
+            trava(&e->trava);
+            if (e->restantes == 0) {
+                destrava(&e->trava);
+                break;
+            }
+            if (e->versao == visto) {
+                e->dormindo++;
+                espera(&e->novidade, &e->trava);
+                e->dormindo--;
+            }
+            destrava(&e->trava);
+            continue;
+        }
+        /* Pausou: vai pro fim da fila, atrás das que estão esperando */
+        if (roda_fatia(e, t)) {
+            poe_fim(minha, t);
+            avisa(e, 0);
+        }
+    }
+    FIO_FIM;
+}
+
+double escalona(Tarefa *t, int n, const ConfigEscalonador *cfg) {
+    Escalonador e;
+    e.cfg = cfg;
+    e.nfilas = cfg->workers > 0 ? cfg->workers : 1;
+    e.restantes = n;
+    e.versao = 0;
+    e.dormindo = 0;
+    trava_inicia(&e.trava);
+    sinal_inicia(&e.novidade);
+
+    /* Distribui em rodízio; o roubo equilibra se as longas caírem juntas */
+    e.filas = aloca(e.nfilas * sizeof(Fila));
+    for (int w = 0; w < e.nfilas; w++) {
+        trava_inicia(&e.filas[w].trava);
+        e.filas[w].cap = n;
+        e.filas[w].anel = aloca(n * sizeof(Tarefa *));
+    }
+    for (int i = 0; i < n; i++) poe_fim(&e.filas[i % e.nfilas], &t[i]);
+
+    Worker *ws = aloca(e.nfilas * sizeof(Worker));
+    Fio *fios = aloca(e.nfilas * sizeof(Fio));
+    e.t0 = agora_ns();
+    for (int w = 0; w < e.nfilas; w++) {
+        ws[w].e = &e;
+        ws[w].eu = w;
+#ifdef _WIN32
+        fios[w] = CreateThread(NULL, 0, trabalha, &ws[w], 0, NULL);
+        if (!fios[w]) { fprintf(stderr, "Erro: não consegui criar a thread\n"); exit(1); }
+#else
+        if (pthread_create(&fios[w], NULL, trabalha, &ws[w]) != 0) {
+            fprintf(stderr, "Erro: não consegui criar a thread\n");
+            exit(1);
+        }
+#endif
+    }
+    for (int w = 0; w < e.nfilas; w++) {
+#ifdef _WIN32
+        WaitForSingleObject(fios[w], INFINITE);
+        CloseHandle(fios[w]);
+#else
+        pthread_join(fios[w], NULL);
+#endif
+    }
+    double total = agora_ns() - e.t0;
+
+    for (int w = 0; w < e.nfilas; w++) {
+        trava_fecha(&e.filas[w].trava);
+        free(e.filas[w].anel);
+    }
+    sinal_fecha(&e.novidade);
+    trava_fecha(&e.trava);
+    free(e.filas);
+    free(ws);
+    free(fios);
+    return total;
+}
@@ -0,0 +1,57 @@
+#ifndef ESCALONADOR_H
+#define ESCALONADOR_H
+
+#include <stddef.h>
+#include "interpretador.h"
+
+/* -------------------- Escalonador de tarefas --------------------
+   Roda muitos programas ao mesmo tempo. Cada programa é uma tarefa com o
+   próprio quadro (registradores + variáveis); o código (CodigoIR) é
+   compartilhado entre as tarefas do mesmo programa e só é lido.
+
+   As tarefas são divididas entre um número fixo de threads (workers), cada
+   uma com sua fila. Um worker pega da frente da própria fila; quando ela
+   esvazia, rouba do fim da fila de outro. Uma tarefa roda até gastar a
+   fatia de passos (conferida nas voltas de laço), e aí volta pro fim da
+   fila: um while que não termina não segura o worker pra sempre.
+
+   Limites por tarefa: passos (a tarefa é encerrada ao passar) e memória
+   (o quadro tem tamanho fixo, então é conferido antes de começar).
+*/
+
+typedef struct {
+    int       workers;        /* threads */
+    long long fatia;          /* passos por vez antes de ceder o worker; 0 = sem preempção */
+    long long limite_passos;  /* 0 = sem limite */
+    size_t    limite_mem;     /* bytes de quadro por tarefa; 0 = sem limite */
+} ConfigEscalonador;
+
+typedef enum {
+    TAREFA_PRONTA,      /* ainda não terminou */
+    TAREFA_OK,
+    TAREFA_ERRO,        /* divisão por zero (q.erro_pos) */
+    TAREFA_PASSOS,      /* passou do limite de passos */
+    TAREFA_MEMORIA      /* quadro maior que o limite, nem começou */
+} EstadoTarefa;
+
+typedef struct {
+    int             id;
+    int             grupo;     /* livre pra quem chama (o bench usa pro programa) */
+    const CodigoIR *c;
+    Quadro          q;         /* q.vars fica com o resultado; liberar com free */
+    EstadoTarefa    estado;
+    int             fatias;    /* quantas vezes foi pro worker */
+    int             roubos;    /* quantas vezes foi roubada */
+    double          fim_ns;    /* quando terminou, contado do início do lote */
+} Tarefa;
+
+/* Preenche c/id/grupo e deixa a tarefa pronta pra escalonar */
+void   tarefa_inicia(Tarefa *t, int id, int grupo, const CodigoIR *c);
+
+/* Roda as n tarefas até todas terminarem. Devolve o tempo total (ns). */
+double escalona(Tarefa *t, int n, const ConfigEscalonador *cfg);
+
+/* Número de processadores (padrão pra cfg.workers) */
+int    escalonador_cpus(void);
+
+#endif
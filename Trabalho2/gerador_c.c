@@ -0,0 +1,290 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L   /* fork, execvp, waitpid */
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "gerador_c.h"
+#include "tipos.h"
+
+/* Cada expressão sai no tipo que a tipagem estática deu pra ela: integer
+   vira conta em int64_t, real em double, e o alargamento vira (double).
+   Soma/subtração/multiplicação inteira passam por funções que dão a volta
+   em 64 bits (igual ao interpretador) em vez de cair em estouro indefinido.
+   Os nomes ganham prefixo "v_" pra não colidir com palavra reservada do C
+   (uma variável chamada "int" ou "main" é válida em MicroPascal). */
+
+static void recuo(FILE *out, int nivel) {
+    for (int i = 0; i < nivel; i++) fputs("    ", out);
+}
+
+static const char *op_c(ASTKind k) {
+    switch (k) {
+        case AST_ADD: return "+";
+        case AST_SUB: return "-";
+        case AST_MUL: return "*";
+        case AST_DIV: return "/";
+        case AST_EQ:  return "==";
+        case AST_NE:  return "!=";
+        case AST_LT:  return "<";
+        case AST_LE:  return "<=";
+        case AST_GT:  return ">";
+        case AST_GE:  return ">=";
+        default:      return "?";
+    }
+}
+
+static void emite_expr(const Programa *prog, const AST *e, FILE *out);
+
+/* Emite e já convertida pro tipo pedido */
+static void emite_conv(const Programa *prog, const AST *e, Tipo para, FILE *out) {
+    if (e->tipo == para) {
+        emite_expr(prog, e, out);
+        return;
+    }
+    fputs(para == TIPO_REAL ? "(double)(" : "mp_trunc(", out);
+    emite_expr(prog, e, out);
+    fputs(")", out);
+}
+
+static void emite_expr(const Programa *prog, const AST *e, FILE *out) {
+    switch (e->kind) {
+        case AST_NUM:
+            if (e->tipo == TIPO_INTEGER) {
+                fprintf(out, "INT64_C(%lld)", e->num.i);
+            } else {
+                /* Literal real sempre com ponto (3 vira 3.0). O que estoura
+                   (1e400) vira infinito, que o C não escreve como número. */
+                if (isinf(e->num.f)) {
+                    fputs(e->num.f > 0 ? "HUGE_VAL" : "(-HUGE_VAL)", out);
+                    break;
+                }
+                char buf[40];
+                snprintf(buf, sizeof buf, "%.17g", e->num.f);
+                fprintf(out, "%s%s", buf, strpbrk(buf, ".en") ? "" : ".0");
+            }
+            break;
+        case AST_VAR:
+            fprintf(out, "v_%s", prog->vars[e->var].nome);
+            break;
+        case AST_NEG:
+            fputs(e->tipo == TIPO_INTEGER ? "mp_neg(" : "(-", out);
+            emite_expr(prog, e->left, out);
+            fputs(")", out);
+            break;
+        case AST_EQ: case AST_NE: case AST_LT: case AST_LE: case AST_GT: case AST_GE: {
+            /* Relação compara no tipo comum e vale integer 0/1 */
+            Tipo t = tipo_comum(e->left->tipo, e->right->tipo);
+            fputs("(int64_t)(", out);
+            emite_conv(prog, e->left, t, out);
+            fprintf(out, " %s ", op_c(e->kind));
+            emite_conv(prog, e->right, t, out);
+            fputs(")", out);
+            break;
+        }
+        default:
+            if (e->tipo == TIPO_INTEGER) {
+                const char *fn = e->kind == AST_ADD ? "mp_add" : e->kind == AST_SUB ? "mp_sub" :
+                                 e->kind == AST_MUL ? "mp_mul" : "mp_div";
+                fprintf(out, "%s(", fn);
+                emite_expr(prog, e->left, out);
+                fputs(", ", out);
+                emite_expr(prog, e->right, out);
+                if (e->kind == AST_DIV) fprintf(out, ", %d, %d", LINHA_COLUNA(prog->fonte, e->pos));
+                fputs(")", out);
+            } else {
+                fputs("(", out);
+                emite_conv(prog, e->left, TIPO_REAL, out);
+                fprintf(out, " %s ", op_c(e->kind));
+                emite_conv(prog, e->right, TIPO_REAL, out);
+                fputs(")", out);
+            }
+            break;
+    }
+}
+
+static void emite_cmd(const Programa *prog, const Comando *c, int nivel, FILE *out) {
+    switch (c->kind) {
+        case CMD_ATRIB: {
+            const Variavel *v = &prog->vars[c->var];
+            recuo(out, nivel);
+            fprintf(out, "v_%s = ", v->nome);
+            emite_conv(prog, c->expr, v->tipo, out);  /* real em integer trunca */
+            fputs(";\n", out);
+            break;
+        }
+        case CMD_COMPOSTO:
+            recuo(out, nivel);
+            fputs("{\n", out);
+            for (const Comando *s = c->corpo; s; s = s->prox) emite_cmd(prog, s, nivel + 1, out);
+            recuo(out, nivel);
+            fputs("}\n", out);
+            break;
+        case CMD_IF:
+            recuo(out, nivel);
+            fputs("if (", out);
+            emite_expr(prog, c->expr, out);
+            fprintf(out, " != 0) {    /* linha %d */\n", fonte_linha(prog->fonte, c->pos));
+            emite_cmd(prog, c->corpo, nivel + 1, out);
+            recuo(out, nivel);
+            fputs("}", out);
+            if (c->senao) {
+                fputs(" else {\n", out);
+                emite_cmd(prog, c->senao, nivel + 1, out);
+                recuo(out, nivel);
+                fputs("}", out);
+            }
+            fputs("\n", out);
+            break;
+        case CMD_WHILE:
+            recuo(out, nivel);
+            fputs("while (", out);
+            emite_expr(prog, c->expr, out);
+            fprintf(out, " != 0) {    /* linha %d */\n", fonte_linha(prog->fonte, c->pos));
+            emite_cmd(prog, c->corpo, nivel + 1, out);
+            recuo(out, nivel);
+            fputs("}\n", out);
+            break;
+    }
+}
+
+/* Aritmética inteira com a mesma semântica do interpretador */
+static const char *prelude =
+    "static inline int64_t mp_add(int64_t a, int64_t b) { return (int64_t)((uint64_t)a + (uint64_t)b); }\n"
+    "static inline int64_t mp_sub(int64_t a, int64_t b) { return (int64_t)((uint64_t)a - (uint64_t)b); }\n"
+    "static inline int64_t mp_mul(int64_t a, int64_t b) { return (int64_t)((uint64_t)a * (uint64_t)b); }\n"
+    "static inline int64_t mp_neg(int64_t a) { return (int64_t)(0 - (uint64_t)a); }\n"
+    "static inline int64_t mp_trunc(double x)   /* mesma regra do trunca_real */\n"
+    "{\n"
+    "    if (x != x) return 0;\n"
+    "    if (x >= 9223372036854775808.0) return INT64_MAX;\n"
+    "    if (x < -9223372036854775808.0) return INT64_MIN;\n"
+    "    return (int64_t)x;\n"
+    "}\n"
+    "static inline int64_t mp_div(int64_t a, int64_t b, int linha, int coluna)   /* mesma regra do div_inteira */\n"
+    "{\n"
+    "    if (b == 0) { fprintf(stderr, \"%d:%d:divisao por zero.\\n\", linha, coluna); exit(EXIT_FAILURE); }\n"
+    "    return b == -1 ? mp_neg(a) : a / b;\n"
+    "}\n\n";
+
+void gera_c(const Programa *prog, const char *origem, FILE *out) {
+    fprintf(out, "/* Gerado pelo compilador MicroPascal a partir de %s (programa %s) */\n",
+            origem ? origem : "?", prog->nome);
+    fputs("#include <stdio.h>\n#include <stdlib.h>\n#include <stdint.h>\n#include <math.h>\n\n", out);
+    fputs(prelude, out);
+    fputs("int main(void)\n{\n", out);
+
+    for (int v = 0; v < prog->nvars; v++) {
+        if (prog->vars[v].tipo == TIPO_INTEGER) fprintf(out, "    int64_t v_%s = 0;\n", prog->vars[v].nome);
+        else                                    fprintf(out, "    double v_%s = 0.0;\n", prog->vars[v].nome);
+    }
+    fputs("\n", out);
+
+    emite_cmd(prog, prog->corpo, 1, out);
+
+    fputs("\n", out);
+    for (int v = 0; v < prog->nvars; v++) {
+        if (prog->vars[v].tipo == TIPO_INTEGER)
+            fprintf(out, "    printf(\"%s = %%lld\\n\", (long long)v_%s);\n", prog->vars[v].nome, prog->vars[v].nome);
+        else
+            fprintf(out, "    printf(\"%s = %%.15g\\n\", v_%s);\n", prog->vars[v].nome, prog->vars[v].nome);
+    }
+    fputs("    return 0;\n}\n", out);
+}
+
+/* Processos: fork/exec no POSIX, _spawnvp no Windows. Nada passa por shell,
+   então nome de arquivo com espaço, aspas ou ';' chega inteiro no programa. */
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#include <process.h>
+
+int roda_processo(char *const argv[], const char *saida) {
+    /* O _spawnvp junta os argumentos com espaço: os que têm espaço vão entre
+       aspas, e aspas no meio não têm como passar direito */
+    char *args[64];
+    int n = 0;
+    for (; argv[n] && n < 63; n++) {
+        if (strchr(argv[n], '"')) {
+            fprintf(stderr, "Erro: argumento com aspas nao suportado: %s\n", argv[n]);
+            for (int k = 0; k < n; k++) free(args[k]);
+            return -1;
+        }
+        size_t t = strlen(argv[n]);
+        args[n] = malloc(t + 3);
+        if (!args[n]) { perror("malloc"); exit(1); }
+        if (strpbrk(argv[n], " \t")) sprintf(args[n], "\"%s\"", argv[n]);
+        else                         memcpy(args[n], argv[n], t + 1);
+    }
+    args[n] = NULL;
+
+    fflush(stdout);
+    int salvo = _dup(1);
+    int fd = _open(saida ? saida : "NUL", _O_WRONLY | _O_CREAT | _O_TRUNC, 0644);
+    if (fd >= 0) { _dup2(fd, 1); _close(fd); }
+    intptr_t r = _spawnvp(_P_WAIT, argv[0], (const char *const *)args);
+    _dup2(salvo, 1);
+    _close(salvo);
+    for (int k = 0; k < n; k++) free(args[k]);
+    return (int)r;
+}
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+int roda_processo(char *const argv[], const char *saida) {
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0) { perror("fork"); return -1; }
+    if (pid == 0) {
+        int fd = open(saida ? saida : "/dev/null", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd >= 0) { dup2(fd, 1); close(fd); }
+        execvp(argv[0], argv);
+        _exit(127);   /* não achou o programa */
+    }
+    int st;
+    while (waitpid(pid, &st, 0) < 0) {}
+    return WIFEXITED(st) ? WEXITSTATUS(st) : -1;
+}
+#endif
+
+int compila_c(const Programa *prog, const char *origem, const char *arquivo_c, const char *executavel) {
+    FILE *out = fopen(arquivo_c, "w");
+    if (!out) {
+        fprintf(stderr, "Erro: não consegui criar '%s'\n", arquivo_c);
+        return 1;
+    }
+    gera_c(prog, origem, out);
+    fclose(out);
+
+    const char *cc = getenv("CC");
+#ifdef _WIN32
+    if (!cc || !*cc) cc = "gcc";
+#else
+    if (!cc || !*cc) cc = "cc";
+#endif
+
+    /* $CC pode vir com argumentos ("ccache gcc"): quebra nos espaços */
+    char *copia = malloc(strlen(cc) + 1);
+    if (!copia) { perror("malloc"); exit(1); }
+    strcpy(copia, cc);
+    char *argv[40];
+    int n = 0;
+    for (char *p = strtok(copia, " \t"); p && n < 34; p = strtok(NULL, " \t")) argv[n++] = p;
+    argv[n++] = "-O2";
+    argv[n++] = "-o";
+    argv[n++] = (char *)executavel;
+    argv[n++] = (char *)arquivo_c;
+    argv[n] = NULL;
+
+    int r = roda_processo(argv, NULL);
+    free(copia);
+    if (r != 0) {
+        fprintf(stderr, "Erro: o compilador C falhou (%s, codigo %d)\n", cc, r);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,26 @@
+#ifndef GERADOR_C_H
+#define GERADOR_C_H
+
+#include <stdio.h>
+#include "sintatico.h"
+
+/* -------------------- Backend AOT --------------------
+   Traduz o programa (a árvore que sai do parse_program) pra uma unidade C
+   autossuficiente: variáveis viram locais tipadas (int64_t / double), as
+   contas saem no tipo estático de cada expressão, if/while viram if/while
+   do C, e no fim o executável imprime o valor final de cada variável no
+   mesmo formato do interpretador.
+*/
+
+void gera_c(const Programa *prog, const char *origem, FILE *out);
+
+/* Roda argv[0] (procurado no PATH) sem passar por shell, com a saída padrão
+   indo pra 'saida' (NULL = descarta). Devolve o código de saída, ou -1 se
+   não conseguiu rodar. */
+int  roda_processo(char *const argv[], const char *saida);
+
+/* Gera o .c e chama o compilador C do sistema ($CC, ou cc/gcc).
+   Devolve 0 se deu certo. */
+int  compila_c(const Programa *prog, const char *origem, const char *arquivo_c, const char *executavel);
+
+#endif
@@ -0,0 +1,32 @@
+/* Laço de execução do interpretador. Não é um header comum: o
+   interpretador.c inclui este arquivo duas vezes, definindo antes
+     INTERP_NOME        nome da função gerada
+     INTERP_AMOSTRA(ip) o que fazer nos desvios (vazio na versão normal)
+     INTERP_DIV_ZERO(ip) o que fazer na divisão por zero (ver interp_ops.h)
+   Assim a versão normal fica sem nenhum teste a mais por causa do perfil. */
+
+void INTERP_NOME(const CodigoIR *c, Valor *vars) {
+    Valor *r = aloca(c->nregs * sizeof(Valor));
+    const Instr *code = c->code;
+    const Instr *ip = code;
+
+    for (;;) {
+        switch (ip->op) {
+#include "interp_ops.h"
+
+            case OP_JMP:
+                INTERP_AMOSTRA(ip);
+                ip = code + ip->a;
+                continue;
+            case OP_BR:
+                INTERP_AMOSTRA(ip);
+                ip = code + (r[ip->dst].i != 0 ? ip->a : ip->b);
+                continue;
+            case OP_RET:
+                for (int v = 0; v < c->prog->nvars; v++) vars[v] = r[c->saida[v]];
+                free(r);
+                return;
+        }
+        ip++;
+    }
+}
@@ -0,0 +1,43 @@
+/* Casos do switch do interpretador pras operações que não desviam.
+   Incluído dentro do switch de cada laço de execução (interp_laco.h e
+   interp_continua); espera r, ip, vars e c em escopo e que quem inclui
+   defina INTERP_DIV_ZERO(ip), o que fazer na divisão inteira por zero. */
+
+            case OP_CONST: r[ip->dst] = ip->cte; break;
+            case OP_PARAM: r[ip->dst] = vars[ip->cte.i]; break;
+            case OP_CONTA: c->conta[ip->a]++; break;
+
+            case OP_ADD_I: r[ip->dst].i = (long long)(U(r[ip->a].i) + U(r[ip->b].i)); break;
+            case OP_SUB_I: r[ip->dst].i = (long long)(U(r[ip->a].i) - U(r[ip->b].i)); break;
+            case OP_MUL_I: r[ip->dst].i = (long long)(U(r[ip->a].i) * U(r[ip->b].i)); break;
+            case OP_NEG_I: r[ip->dst].i = (long long)(0 - U(r[ip->a].i)); break;
+            case OP_DIV_I: {
+                long long d = r[ip->b].i;
+                if (d == 0) INTERP_DIV_ZERO(ip);
+                r[ip->dst].i = div_inteira(r[ip->a].i, d);
+                break;
+            }
+
+            case OP_ADD_R: r[ip->dst].f = r[ip->a].f + r[ip->b].f; break;
+            case OP_SUB_R: r[ip->dst].f = r[ip->a].f - r[ip->b].f; break;
+            case OP_MUL_R: r[ip->dst].f = r[ip->a].f * r[ip->b].f; break;
+            case OP_DIV_R: r[ip->dst].f = r[ip->a].f / r[ip->b].f; break;
+            case OP_NEG_R: r[ip->dst].f = -r[ip->a].f; break;
+
+            case OP_I2F:   r[ip->dst].f = (double)r[ip->a].i; break;
+            case OP_TRUNC: r[ip->dst].i = trunca_real(r[ip->a].f); break;
+
+            case OP_EQ_I:  r[ip->dst].i = r[ip->a].i == r[ip->b].i; break;
+            case OP_NE_I:  r[ip->dst].i = r[ip->a].i != r[ip->b].i; break;
+            case OP_LT_I:  r[ip->dst].i = r[ip->a].i <  r[ip->b].i; break;
+            case OP_LE_I:  r[ip->dst].i = r[ip->a].i <= r[ip->b].i; break;
+            case OP_GT_I:  r[ip->dst].i = r[ip->a].i >  r[ip->b].i; break;
+            case OP_GE_I:  r[ip->dst].i = r[ip->a].i >= r[ip->b].i; break;
+            case OP_EQ_R:  r[ip->dst].i = r[ip->a].f == r[ip->b].f; break;
+            case OP_NE_R:  r[ip->dst].i = r[ip->a].f != r[ip->b].f; break;
+            case OP_LT_R:  r[ip->dst].i = r[ip->a].f <  r[ip->b].f; break;
+            case OP_LE_R:  r[ip->dst].i = r[ip->a].f <= r[ip->b].f; break;
+            case OP_GT_R:  r[ip->dst].i = r[ip->a].f >  r[ip->b].f; break;
+            case OP_GE_R:  r[ip->dst].i = r[ip->a].f >= r[ip->b].f; break;
+
+            case OP_MOV:   r[ip->dst] = r[ip->a]; break;
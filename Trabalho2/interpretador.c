@@ -0,0 +1,269 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "interpretador.h"
+#include "tipos.h"
+
+/* Opcodes já resolvidos por tipo: _I trabalha em int64, _R em double.
+   As relações _I/_R dizem o tipo dos operandos; o resultado é sempre integer. */
+enum {
+    OP_CONST, OP_PARAM, OP_CONTA,
+    OP_ADD_I, OP_SUB_I, OP_MUL_I, OP_DIV_I, OP_NEG_I,
+    OP_ADD_R, OP_SUB_R, OP_MUL_R, OP_DIV_R, OP_NEG_R,
+    OP_I2F, OP_TRUNC,
+    OP_EQ_I, OP_NE_I, OP_LT_I, OP_LE_I, OP_GT_I, OP_GE_I,
+    OP_EQ_R, OP_NE_R, OP_LT_R, OP_LE_R, OP_GT_R, OP_GE_R,
+    OP_MOV, OP_JMP, OP_BR, OP_RET
+};
+
+static void *aloca(size_t n) {
+    void *m = calloc(1, n ? n : 1);
+    if (!m) { perror("calloc"); exit(1); }
+    return m;
+}
+
+static int emite(CodigoIR *c, int op, int dst, int a, int b) {
+    if (c->ncode == c->capcode) {
+        c->capcode = c->capcode ? c->capcode * 2 : 64;
+        c->code = realloc(c->code, c->capcode * sizeof(Instr));
+        if (!c->code) { perror("realloc"); exit(1); }
+    }
+    Instr *in = &c->code[c->ncode];
+    in->op = (unsigned char)op;
+    in->dst = dst;
+    in->a = a;
+    in->b = b;
+    in->cte.i = 0;
+    in->pos = -1;
+    return c->ncode++;
+}
+
+/* Escolhe o opcode especializado pro valor */
+static int opcode(const IRFuncao *f, const IRValor *v) {
+    int real = (v->op >= IR_EQ ? f->vals[v->a].tipo : v->tipo) == TIPO_REAL;
+    switch (v->op) {
+        case IR_CONST: return OP_CONST;
+        case IR_PARAM: return OP_PARAM;
+        case IR_ADD:   return real ? OP_ADD_R : OP_ADD_I;
+        case IR_SUB:   return real ? OP_SUB_R : OP_SUB_I;
+        case IR_MUL:   return real ? OP_MUL_R : OP_MUL_I;
+        case IR_DIV:   return real ? OP_DIV_R : OP_DIV_I;
+        case IR_NEG:   return real ? OP_NEG_R : OP_NEG_I;
+        case IR_I2F:   return OP_I2F;
+        case IR_TRUNC: return OP_TRUNC;
+        case IR_EQ:    return real ? OP_EQ_R : OP_EQ_I;
+        case IR_NE:    return real ? OP_NE_R : OP_NE_I;
+        case IR_LT:    return real ? OP_LT_R : OP_LT_I;
+        case IR_LE:    return real ? OP_LE_R : OP_LE_I;
+        case IR_GT:    return real ? OP_GT_R : OP_GT_I;
+        case IR_GE:    return real ? OP_GE_R : OP_GE_I;
+        default:       return OP_MOV; /* phi não chega aqui */
+    }
+}
+
+/* Cópias das phis de 'para' vindas do bloco 'de'. Todas as phis leem
+   ao mesmo tempo, então primeiro copia pros temporários e depois pras phis
+   (senão um laço que troca a e b de lugar sairia errado). */
+static void emite_phis(CodigoIR *c, const IRFuncao *f, int de, int para) {
+    const IRBloco *b = &f->blocos[para];
+    int k = (b->pred[0] == de) ? 0 : 1;
+    int nphis = 0;
+    for (int i = 0; i < b->ninstrs; i++) {
+        const IRValor *v = &f->vals[b->instrs[i]];
+        if (v->op != IR_PHI) break;
+        int pc = emite(c, OP_MOV, f->nvals + nphis, k == 0 ? v->a : v->b, -1);
+        c->code[pc].pos = v->pos;
+        nphis++;
+    }
+    for (int i = 0; i < nphis; i++) {
+        int pc = emite(c, OP_MOV, b->instrs[i], f->nvals + i, -1);
+        c->code[pc].pos = f->vals[b->instrs[i]].pos;
+    }
+    if (f->nvals + nphis > c->nregs) c->nregs = f->nvals + nphis;
+}
+
+static CodigoIR *prepara(const IRFuncao *f, int instrumenta) {
+    CodigoIR *c = aloca(sizeof(CodigoIR));
+    c->prog = f->prog;
+    c->nregs = f->nvals;
+    c->nblocos = f->nblocos;
+
+    int *inicio = aloca(f->nblocos * sizeof(int));   /* posição de cada bloco no código */
+    int *pend = aloca(f->nblocos * 2 * sizeof(int)); /* desvios pra corrigir depois */
+    int npend = 0;
+
+    for (int bi = 0; bi < f->nblocos; bi++) {
+        const IRBloco *b = &f->blocos[bi];
+        inicio[bi] = c->ncode;
+        if (instrumenta) emite(c, OP_CONTA, -1, bi, -1);
+
+        for (int k = 0; k < b->ninstrs; k++) {
+            const IRValor *v = &f->vals[b->instrs[k]];
+            if (v->op == IR_PHI) continue;
+            int pc = emite(c, opcode(f, v), b->instrs[k], v->a, v->b);
+            c->code[pc].cte = v->cte;
+            c->code[pc].pos = v->pos;
+        }
+
+        switch (b->term) {
+            case TERM_JMP:
+                emite_phis(c, f, bi, b->succ[0]);
+                /* Se o destino é o próximo bloco, só cai nele */
+                if (b->succ[0] != bi + 1) pend[npend++] = emite(c, OP_JMP, -1, b->succ[0], -1);
+                break;
+            case TERM_BR:
+                pend[npend++] = emite(c, OP_BR, b->cond, b->succ[0], b->succ[1]);
+                c->code[pend[npend - 1]].pos = f->vals[b->cond].pos;
+                break;
+            case TERM_RET:
+                emite(c, OP_RET, -1, -1, -1);
+                break;
+        }
+    }
+
+    for (int i = 0; i < npend; i++) {
+        Instr *in = &c->code[pend[i]];
+        in->a = inicio[in->a];
+        if (in->op == OP_BR) in->b = inicio[in->b];
+    }
+
+    c->saida = aloca(f->prog->nvars * sizeof(int));
+    memcpy(c->saida, f->saida, f->prog->nvars * sizeof(int));
+
+    /* Contadores do perfil: bloco de cada instrução, execuções e amostras */
+    c->inicio = inicio;
+    c->bloco_de = aloca(c->ncode * sizeof(int));
+    for (int bi = 0; bi < f->nblocos; bi++) {
+        int fim = (bi + 1 < f->nblocos) ? inicio[bi + 1] : c->ncode;
+        for (int pc = inicio[bi]; pc < fim; pc++) c->bloco_de[pc] = bi;
+    }
+    c->conta = aloca(f->nblocos * sizeof(long long));
+    c->amostras = aloca(f->nblocos * sizeof(long long));
+    free(pend);
+    return c;
+}
+
+CodigoIR *interp_prepara(const IRFuncao *f) {
+    return prepara(f, 0);
+}
+
+CodigoIR *interp_prepara_perfil(const IRFuncao *f) {
+    return prepara(f, 1);
+}
+
+int interp_conta_instr(const CodigoIR *c, int pc) {
+    int op = c->code[pc].op;
+    return op != OP_CONTA && op != OP_JMP && op != OP_RET;
+}
+
+/* Inteiros dão a volta em 64 bits (igual ao ir_dobra e ao C gerado) */
+#define U(x) ((unsigned long long)(x))
+
+#define INTERP_DIV_ZERO(ip) do { \
+        fprintf(stderr, "%d:%d:divisao por zero.\n", LINHA_COLUNA(c->prog->fonte, (ip)->pos)); \
+        exit(EXIT_FAILURE); \
+    } while (0)
+
+#define INTERP_NOME interp_executa
+#define INTERP_AMOSTRA(ip)
+#include "interp_laco.h"
+#undef INTERP_NOME
+#undef INTERP_AMOSTRA
+
+/* Versão com amostragem: o relógio do perfil só liga a bandeira, e quem
+   anota a amostra é o próximo desvio (conta pro bloco que acabou de rodar) */
+volatile sig_atomic_t interp_amostrar = 0;
+
+#define INTERP_NOME interp_executa_amostrando
+#define INTERP_AMOSTRA(ip) \
+    if (interp_amostrar) { interp_amostrar = 0; c->amostras[c->bloco_de[(ip) - code]]++; }
+#include "interp_laco.h"
+#undef INTERP_NOME
+#undef INTERP_AMOSTRA
+#undef INTERP_DIV_ZERO
+
+/* Versão em fatias pro escalonador: o estado fica todo no quadro, a divisão
+   por zero devolve erro em vez de derrubar o processo, e só as voltas de
+   laço (desvio pra trás) contam passos e podem pausar. Cada volta cobra o
+   tamanho do laço no código, então o contador fica perto das instruções
+   executadas sem custar nada fora dos desvios. */
+int interp_continua(const CodigoIR *c, Quadro *q, long long orcamento) {
+    Valor *r = q->r;
+    Valor *vars = q->vars;
+    const Instr *code = c->code;
+    const Instr *ip = code + q->pc;
+    long long fim = q->passos + orcamento;
+
+#define INTERP_DIV_ZERO(ip) do { \
+        q->pc = (int)((ip) - code); \
+        q->erro_pos = (ip)->pos; \
+        return INTERP_ERRO; \
+    } while (0)
+
+    for (;;) {
+        switch (ip->op) {
+#include "interp_ops.h"
+
+            case OP_JMP:
+            case OP_BR: {
+                int de = (int)(ip - code);
+                int para = (ip->op == OP_JMP || r[ip->dst].i != 0) ? ip->a : ip->b;
+                ip = code + para;
+                if (para <= de) {
+                    q->passos += de - para + 1;
+                    if (q->passos >= fim) {
+                        q->pc = para;
+                        return INTERP_PAUSOU;
+                    }
+                }
+                continue;
+            }
+            case OP_RET:
+                for (int v = 0; v < c->prog->nvars; v++) vars[v] = r[c->saida[v]];
+                q->pc = (int)(ip - code);
+                return INTERP_TERMINOU;
+        }
+        ip++;
+    }
+#undef INTERP_DIV_ZERO
+}
+
+size_t interp_quadro_bytes(const CodigoIR *c) {
+    return (size_t)(c->nregs + c->prog->nvars) * sizeof(Valor);
+}
+
+void interp_quadro_inicia(const CodigoIR *c, Quadro *q) {
+    q->r = aloca(c->nregs * sizeof(Valor));
+    q->vars = aloca(c->prog->nvars * sizeof(Valor));
+    q->pc = 0;
+    q->passos = 0;
+    q->erro_pos = -1;
+}
+
+void interp_quadro_libera(Quadro *q) {
+    free(q->r);
+    q->r = NULL;
+    /* q->vars fica: é o resultado da tarefa; quem criou o quadro libera */
+}
+
+#undef U
+
+void interp_free(CodigoIR *c) {
+    if (!c) return;
+    free(c->code);
+    free(c->saida);
+    free(c->inicio);
+    free(c->bloco_de);
+    free(c->conta);
+    free(c->amostras);
+    free(c);
+}
+
+void imprime_variaveis(const Programa *prog, const Valor *vars, FILE *out) {
+    for (int v = 0; v < prog->nvars; v++) {
+        if (prog->vars[v].tipo == TIPO_INTEGER)
+            fprintf(out, "%s = %lld\n", prog->vars[v].nome, vars[v].i);
+        else
+            fprintf(out, "%s = %.15g\n", prog->vars[v].nome, vars[v].f);
+    }
+}
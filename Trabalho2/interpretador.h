@@ -0,0 +1,82 @@
+#ifndef INTERPRETADOR_H
+#define INTERPRETADOR_H
+
+#include <stdio.h>
+#include <signal.h>
+#include "ir.h"
+
+/* -------------------- Interpretador da IR --------------------
+   A IR é achatada num vetor de instruções (blocos em sequência, phis
+   viram cópias no fim do bloco que salta pra junção) e executada num
+   laço com switch. Cada valor SSA tem seu registrador.
+
+   Os registradores não têm etiqueta de tipo: a tipagem estática já decidiu
+   tudo, então cada operação vem especializada (soma inteira e soma real são
+   opcodes diferentes) e lê direto .i ou .f do registrador.
+*/
+
+typedef struct {
+    unsigned char op;
+    int    dst, a, b;   /* registradores; nos desvios, a/b viram posições no código */
+    Valor  cte;
+    int    pos;         /* byte no fonte, pra mensagem de divisão por zero */
+} Instr;
+
+typedef struct {
+    const Programa *prog;
+    Instr *code;  int ncode, capcode;
+    int    nregs;
+    int   *saida;      /* registrador com o valor final de cada variável */
+
+    /* Perfil (ver perfil.h). O código de bloco bi começa em inicio[bi]. */
+    int        nblocos;
+    int       *inicio;
+    int       *bloco_de;   /* bloco de cada instrução */
+    long long *conta;      /* execuções de cada bloco (só no código instrumentado) */
+    long long *amostras;   /* amostras de tempo caídas em cada bloco */
+} CodigoIR;
+
+CodigoIR *interp_prepara(const IRFuncao *f);
+/* Igual, mas cada bloco começa contando quantas vezes rodou em c->conta */
+CodigoIR *interp_prepara_perfil(const IRFuncao *f);
+/* vars (nvars valores): entra o estado inicial, sai o estado final */
+void      interp_executa(const CodigoIR *c, Valor *vars);
+
+/* Igual ao interp_executa, mas a cada desvio olha interp_amostrar: se
+   estiver ligada, anota uma amostra pro bloco atual em c->amostras.
+   É quem liga a bandeira (o relógio do perfil) que decide a frequência. */
+extern volatile sig_atomic_t interp_amostrar;
+void      interp_executa_amostrando(const CodigoIR *c, Valor *vars);
+
+/* Execução em fatias (escalonador): todo o estado de uma execução fica no
+   quadro, então dá pra parar numa volta de laço e continuar depois,
+   inclusive em outra thread. */
+typedef struct {
+    Valor    *r;           /* registradores */
+    Valor    *vars;        /* entra o estado inicial, sai o final */
+    int       pc;          /* onde continuar */
+    long long passos;      /* instruções executadas (contadas nas voltas de laço) */
+    int       erro_pos;    /* INTERP_ERRO: byte no fonte da divisão por zero */
+} Quadro;
+
+enum { INTERP_TERMINOU, INTERP_PAUSOU, INTERP_ERRO };
+
+/* Memória de um quadro desse código (registradores + variáveis) */
+size_t    interp_quadro_bytes(const CodigoIR *c);
+/* Aloca registradores e variáveis (zeradas) e aponta pro começo */
+void      interp_quadro_inicia(const CodigoIR *c, Quadro *q);
+/* Solta os registradores; as variáveis (resultado) ficam com quem chamou */
+void      interp_quadro_libera(Quadro *q);
+/* Roda até terminar, dar erro ou passar de 'orcamento' passos a mais
+   (só confere nas voltas de laço). Devolve INTERP_TERMINOU/PAUSOU/ERRO. */
+int       interp_continua(const CodigoIR *c, Quadro *q, long long orcamento);
+
+/* A instrução em pc conta como operação executada? (os contadores, os
+   saltos incondicionais e o ret não contam) */
+int       interp_conta_instr(const CodigoIR *c, int pc);
+void      interp_free(CodigoIR *c);
+
+/* "nome = valor", uma variável por linha (mesmo formato do executável gerado) */
+void      imprime_variaveis(const Programa *prog, const Valor *vars, FILE *out);
+
+#endif
@@ -0,0 +1,438 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ir.h"
+#include "tipos.h"
+
+/* Geração da IR a partir da árvore do parser.
+   Como a linguagem só tem if/while (nada de goto), dá pra montar a SSA direto
+   durante a descida: a gente carrega um mapa "variável -> valor atual" e
+   cria as phis na junção do if e na cabeça do while.
+*/
+
+typedef struct {
+    IRFuncao *f;
+    int  bloco;     /* bloco onde as instruções estão sendo emitidas */
+    int *atual;     /* valor SSA atual de cada variável */
+} Gerador;
+
+static void *aloca(size_t n) {
+    void *m = calloc(1, n ? n : 1);
+    if (!m) { perror("calloc"); exit(1); }
+    return m;
+}
+
+/* Mesmo esquema do TokenVec: dobra a capacidade quando enche */
+static void *cresce(void *p, int *cap, int n, size_t elem) {
+    if (n < *cap) return p;
+    int nc = *cap ? *cap * 2 : 16;
+    void *np = realloc(p, nc * elem);
+    if (!np) { perror("realloc"); exit(1); }
+    *cap = nc;
+    return np;
+}
+
+static int novo_bloco(IRFuncao *f) {
+    f->blocos = cresce(f->blocos, &f->capblocos, f->nblocos, sizeof(IRBloco));
+    IRBloco *b = &f->blocos[f->nblocos];
+    memset(b, 0, sizeof(*b));
+    b->cond = -1;
+    b->succ[0] = b->succ[1] = -1;
+    b->term = TERM_RET;
+    return f->nblocos++;
+}
+
+static void liga(IRFuncao *f, int de, int para) {
+    IRBloco *b = &f->blocos[para];
+    b->pred[b->npred++] = de;
+}
+
+static void salta(IRFuncao *f, int de, int para) {
+    f->blocos[de].term = TERM_JMP;
+    f->blocos[de].succ[0] = para;
+    liga(f, de, para);
+}
+
+static void desvia(IRFuncao *f, int de, int cond, int sim, int nao) {
+    IRBloco *b = &f->blocos[de];
+    b->term = TERM_BR;
+    b->cond = cond;
+    b->succ[0] = sim;
+    b->succ[1] = nao;
+    liga(f, de, sim);
+    liga(f, de, nao);
+}
+
+static void anexa(IRFuncao *f, int bloco, int val) {
+    IRBloco *b = &f->blocos[bloco];
+    b->instrs = cresce(b->instrs, &b->capinstrs, b->ninstrs, sizeof(int));
+    b->instrs[b->ninstrs++] = val;
+}
+
+static int novo_valor(Gerador *g, IROp op, Tipo tipo, int a, int b, int pos) {
+    IRFuncao *f = g->f;
+    f->vals = cresce(f->vals, &f->capvals, f->nvals, sizeof(IRValor));
+    IRValor *v = &f->vals[f->nvals];
+    v->op = op;
+    v->tipo = tipo;
+    v->bloco = g->bloco;
+    v->a = a;
+    v->b = b;
+    v->cte.i = 0;
+    v->var = -1;
+    v->pos = pos;
+    anexa(f, g->bloco, f->nvals);
+    return f->nvals++;
+}
+
+static int constante(Gerador *g, Tipo tipo, Valor num, int pos) {
+    int v = novo_valor(g, IR_CONST, tipo, -1, -1, pos);
+    g->f->vals[v].cte = num;
+    return v;
+}
+
+/* Coloca o valor no tipo pedido (integer -> real alarga, real -> integer trunca) */
+static int converte(Gerador *g, int v, Tipo para, int pos) {
+    Tipo de = g->f->vals[v].tipo;
+    if (de == para) return v;
+    return novo_valor(g, para == TIPO_REAL ? IR_I2F : IR_TRUNC, para, v, -1, pos);
+}
+
+/* --- Expressões --- */
+
+static IROp op_de(ASTKind k) {
+    switch (k) {
+        case AST_ADD: return IR_ADD;
+        case AST_SUB: return IR_SUB;
+        case AST_MUL: return IR_MUL;
+        case AST_DIV: return IR_DIV;
+        case AST_EQ:  return IR_EQ;
+        case AST_NE:  return IR_NE;
+        case AST_LT:  return IR_LT;
+        case AST_LE:  return IR_LE;
+        case AST_GT:  return IR_GT;
+        case AST_GE:  return IR_GE;
+        default:      return IR_NEG;
+    }
+}
+
+static int gera_expr(Gerador *g, const AST *e) {
+    switch (e->kind) {
+        case AST_NUM: return constante(g, e->tipo, e->num, e->pos);
+        case AST_VAR: return g->atual[e->var];
+        case AST_NEG: return novo_valor(g, IR_NEG, e->tipo, gera_expr(g, e->left), -1, e->pos);
+        default: {
+            /* Operandos no tipo comum; na relação o resultado é integer */
+            Tipo t = tipo_comum(e->left->tipo, e->right->tipo);
+            int a = converte(g, gera_expr(g, e->left), t, e->pos);
+            int b = converte(g, gera_expr(g, e->right), t, e->pos);
+            return novo_valor(g, op_de(e->kind), e->tipo, a, b, e->pos);
+        }
+    }
+}
+
+/* Condição de if/while: o desvio testa um integer (real vira x <> 0.0) */
+static int gera_cond(Gerador *g, const AST *e) {
+    int v = gera_expr(g, e);
+    if (g->f->vals[v].tipo == TIPO_INTEGER) return v;
+    Valor z;
+    z.f = 0.0;
+    int zero = constante(g, TIPO_REAL, z, e->pos);
+    return novo_valor(g, IR_NE, TIPO_INTEGER, v, zero, e->pos);
+}
+
+/* --- Comandos --- */
+
+/* Marca quem é atribuído dentro do comando (pra saber quais phis o while precisa) */
+static void atribuidas(const Comando *c, char *marca) {
+    for (; c; c = c->prox) {
+        if (c->kind == CMD_ATRIB) marca[c->var] = 1;
+        atribuidas(c->corpo, marca);
+        atribuidas(c->senao, marca);
+    }
+}
+
+static void gera_cmd(Gerador *g, const Comando *c);
+
+static void gera_lista(Gerador *g, const Comando *c) {
+    for (; c; c = c->prox) gera_cmd(g, c);
+}
+
+static void gera_if(Gerador *g, const Comando *c) {
+    IRFuncao *f = g->f;
+    int nv = f->prog->nvars;
+    int cond = gera_cond(g, c->expr);
+    int entrada = g->bloco;
+
+    /* Sempre cria o bloco do else (mesmo vazio) pra não ter aresta crítica */
+    int bsim = novo_bloco(f);
+    int bnao = novo_bloco(f);
+    desvia(f, entrada, cond, bsim, bnao);
+
+    int *antes = aloca(nv * sizeof(int));
+    int *no_sim = aloca(nv * sizeof(int));
+    memcpy(antes, g->atual, nv * sizeof(int));
+
+    g->bloco = bsim;
+    gera_cmd(g, c->corpo);
+    int fim_sim = g->bloco;
+    memcpy(no_sim, g->atual, nv * sizeof(int));
+
+    memcpy(g->atual, antes, nv * sizeof(int));
+    g->bloco = bnao;
+    if (c->senao) gera_cmd(g, c->senao);
+    int fim_nao = g->bloco;
+
+    int junta = novo_bloco(f);
+    salta(f, fim_sim, junta);
+    salta(f, fim_nao, junta);
+    g->bloco = junta;
+
+    /* Onde os dois lados discordam, precisa de phi */
+    for (int v = 0; v < nv; v++) {
+        if (no_sim[v] != g->atual[v]) {
+            int phi = novo_valor(g, IR_PHI, f->prog->vars[v].tipo, no_sim[v], g->atual[v], c->pos);
+            f->vals[phi].var = v;
+            g->atual[v] = phi;
+        }
+    }
+    free(antes);
+    free(no_sim);
+}
+
+static void gera_while(Gerador *g, const Comando *c) {
+    IRFuncao *f = g->f;
+    int nv = f->prog->nvars;
+    char *marca = aloca(nv);
+    atribuidas(c->corpo, marca);
+
+    int pre = g->bloco;
+    int cabeca = novo_bloco(f);
+    salta(f, pre, cabeca);
+    g->bloco = cabeca;
+
+    /* Phis pras variáveis que o corpo altera; o segundo operando (valor
+       que volta do fim do corpo) só é conhecido depois de gerar o corpo. */
+    int *phis = aloca(nv * sizeof(int));
+    for (int v = 0; v < nv; v++) {
+        phis[v] = -1;
+        if (!marca[v]) continue;
+        phis[v] = novo_valor(g, IR_PHI, f->prog->vars[v].tipo, g->atual[v], -1, c->pos);
+        f->vals[phis[v]].var = v;
+        g->atual[v] = phis[v];
+    }
+
+    int cond = gera_cond(g, c->expr);
+    int corpo = novo_bloco(f);
+
+    g->bloco = corpo;
+    gera_cmd(g, c->corpo);
+    salta(f, g->bloco, cabeca);
+    for (int v = 0; v < nv; v++) {
+        if (phis[v] >= 0) {
+            f->vals[phis[v]].b = g->atual[v];
+            g->atual[v] = phis[v]; /* na saída valem os valores da cabeça */
+        }
+    }
+
+    int saida = novo_bloco(f);
+    desvia(f, cabeca, cond, corpo, saida);
+
+    f->lacos = cresce(f->lacos, &f->caplacos, f->nlacos, sizeof(IRLaco));
+    IRLaco *l = &f->lacos[f->nlacos++];
+    l->cabeca = cabeca;
+    l->preheader = pre;
+    l->primeiro = cabeca;
+    l->ultimo = saida - 1;
+    l->pos = c->pos;
+
+    g->bloco = saida;
+    free(marca);
+    free(phis);
+}
+
+static void gera_cmd(Gerador *g, const Comando *c) {
+    switch (c->kind) {
+        case CMD_ATRIB: {
+            /* real numa variável integer: trunca */
+            int v = converte(g, gera_expr(g, c->expr), g->f->prog->vars[c->var].tipo, c->pos);
+            /* Atribuir uma variável a outra (x := y) não gera instrução:
+               x passa a ser o mesmo valor de y. */
+            if (g->f->vals[v].var < 0) g->f->vals[v].var = c->var;
+            g->atual[c->var] = v;
+            break;
+        }
+        case CMD_COMPOSTO: gera_lista(g, c->corpo); break;
+        case CMD_IF:       gera_if(g, c); break;
+        case CMD_WHILE:    gera_while(g, c); break;
+    }
+}
+
+IRFuncao *ir_gera(const Programa *prog) {
+    IRFuncao *f = aloca(sizeof(IRFuncao));
+    f->prog = prog;
+
+    Gerador g;
+    g.f = f;
+    g.bloco = novo_bloco(f);
+    g.atual = aloca(prog->nvars * sizeof(int));
+
+    /* Antes de qualquer atribuição a variável tem o valor do estado inicial
+       (zero na execução normal; o executor em lote varia isso por instância) */
+    for (int v = 0; v < prog->nvars; v++) {
+        g.atual[v] = novo_valor(&g, IR_PARAM, prog->vars[v].tipo, -1, -1, -1);
+        f->vals[g.atual[v]].cte.i = v;
+        f->vals[g.atual[v]].var = v;
+    }
+
+    gera_cmd(&g, prog->corpo);
+
+    f->blocos[g.bloco].term = TERM_RET;
+    f->saida = g.atual;
+    return f;
+}
+
+/* --- Utilidades --- */
+
+int ir_conta_instrs(const IRFuncao *f) {
+    int n = 0;
+    for (int b = 0; b < f->nblocos; b++) n += f->blocos[b].ninstrs;
+    return n;
+}
+
+int ir_dobra(IROp op, Tipo t, Valor a, Valor b, Valor *res) {
+    if (op == IR_I2F)   { res->f = (double)a.i; return 1; }
+    if (op == IR_TRUNC) { res->i = trunca_real(a.f); return 1; }
+
+    if (t == TIPO_INTEGER) {
+        /* Conta em unsigned pra dar a volta em vez de estouro indefinido */
+        unsigned long long x = (unsigned long long)a.i, y = (unsigned long long)b.i;
+        switch (op) {
+            case IR_ADD: res->i = (long long)(x + y); return 1;
+            case IR_SUB: res->i = (long long)(x - y); return 1;
+            case IR_MUL: res->i = (long long)(x * y); return 1;
+            case IR_NEG: res->i = (long long)(0 - x); return 1;
+            case IR_DIV:
+                if (b.i == 0) return 0;
+                res->i = div_inteira(a.i, b.i);
+                return 1;
+            case IR_EQ:  res->i = a.i == b.i; return 1;
+            case IR_NE:  res->i = a.i != b.i; return 1;
+            case IR_LT:  res->i = a.i <  b.i; return 1;
+            case IR_LE:  res->i = a.i <= b.i; return 1;
+            case IR_GT:  res->i = a.i >  b.i; return 1;
+            case IR_GE:  res->i = a.i >= b.i; return 1;
+            default:     return 0;
+        }
+    }
+
+    switch (op) {
+        case IR_ADD: res->f = a.f + b.f; return 1;
+        case IR_SUB: res->f = a.f - b.f; return 1;
+        case IR_MUL: res->f = a.f * b.f; return 1;
+        case IR_DIV: res->f = a.f / b.f; return 1;
+        case IR_NEG: res->f = -a.f; return 1;
+        case IR_EQ:  res->i = a.f == b.f; return 1;
+        case IR_NE:  res->i = a.f != b.f; return 1;
+        case IR_LT:  res->i = a.f <  b.f; return 1;
+        case IR_LE:  res->i = a.f <= b.f; return 1;
+        case IR_GT:  res->i = a.f >  b.f; return 1;
+        case IR_GE:  res->i = a.f >= b.f; return 1;
+        default:     return 0;
+    }
+}
+
+int ir_pode_falhar(const IRFuncao *f, int v) {
+    const IRValor *x = &f->vals[v];
+    if (x->op != IR_DIV || x->tipo != TIPO_INTEGER) return 0;
+    const IRValor *d = &f->vals[x->b];
+    return !(d->op == IR_CONST && d->cte.i != 0);
+}
+
+static const char *nome_op(IROp op) {
+    switch (op) {
+        case IR_CONST: return "const";
+        case IR_PARAM: return "param";
+        case IR_PHI:   return "phi";
+        case IR_ADD:   return "add";
+        case IR_SUB:   return "sub";
+        case IR_MUL:   return "mul";
+        case IR_DIV:   return "div";
+        case IR_NEG:   return "neg";
+        case IR_I2F:   return "i2f";
+        case IR_TRUNC: return "trunc";
+        case IR_EQ:    return "eq";
+        case IR_NE:    return "ne";
+        case IR_LT:    return "lt";
+        case IR_LE:    return "le";
+        case IR_GT:    return "gt";
+        case IR_GE:    return "ge";
+    }
+    return "?";
+}
+
+void ir_dump(const IRFuncao *f, FILE *out) {
+    const Programa *prog = f->prog;
+    fprintf(out, "; programa %s: %d blocos, %d instrucoes\n",
+            prog->nome, f->nblocos, ir_conta_instrs(f));
+
+    for (int bi = 0; bi < f->nblocos; bi++) {
+        const IRBloco *b = &f->blocos[bi];
+        fprintf(out, "b%d:", bi);
+        if (b->npred) {
+            fprintf(out, "    ; preds");
+            for (int k = 0; k < b->npred; k++) fprintf(out, " b%d", b->pred[k]);
+        }
+        for (int l = 0; l < f->nlacos; l++) {
+            if (f->lacos[l].cabeca == bi) fprintf(out, "    ; cabeca do while (linha %d)", fonte_linha(f->prog->fonte, f->lacos[l].pos));
+        }
+        fprintf(out, "\n");
+
+        for (int k = 0; k < b->ninstrs; k++) {
+            const IRValor *v = &f->vals[b->instrs[k]];
+            char buf[96];
+            /* Sufixo .i/.r: tipo da conta (na relação, o tipo dos operandos) */
+            char t = v->tipo == TIPO_INTEGER ? 'i' : 'r';
+            if (v->op >= IR_EQ) t = f->vals[v->a].tipo == TIPO_INTEGER ? 'i' : 'r';
+
+            if (v->op == IR_CONST && v->tipo == TIPO_INTEGER) {
+                snprintf(buf, sizeof buf, "%%%d = const.i %lld", b->instrs[k], v->cte.i);
+            } else if (v->op == IR_CONST) {
+                snprintf(buf, sizeof buf, "%%%d = const.r %g", b->instrs[k], v->cte.f);
+            } else if (v->op == IR_PARAM) {
+                snprintf(buf, sizeof buf, "%%%d = param.%c", b->instrs[k], t);
+            } else if (v->op == IR_PHI) {
+                snprintf(buf, sizeof buf, "%%%d = phi.%c [%%%d, b%d] [%%%d, b%d]", b->instrs[k], t,
+                         v->a, b->pred[0], v->b, b->pred[1]);
+            } else if (v->op == IR_I2F || v->op == IR_TRUNC) {
+                snprintf(buf, sizeof buf, "%%%d = %s %%%d", b->instrs[k], nome_op(v->op), v->a);
+            } else if (v->b < 0) {
+                snprintf(buf, sizeof buf, "%%%d = %s.%c %%%d", b->instrs[k], nome_op(v->op), t, v->a);
+            } else {
+                snprintf(buf, sizeof buf, "%%%d = %s.%c %%%d, %%%d", b->instrs[k], nome_op(v->op), t, v->a, v->b);
+            }
+            if (v->var >= 0) fprintf(out, "  %-36s ; %s\n", buf, prog->vars[v->var].nome);
+            else             fprintf(out, "  %s\n", buf);
+        }
+
+        switch (b->term) {
+            case TERM_JMP: fprintf(out, "  jmp b%d\n", b->succ[0]); break;
+            case TERM_BR:  fprintf(out, "  br %%%d, b%d, b%d\n", b->cond, b->succ[0], b->succ[1]); break;
+            case TERM_RET:
+                fprintf(out, "  ret");
+                for (int v = 0; v < prog->nvars; v++) fprintf(out, " %s=%%%d", prog->vars[v].nome, f->saida[v]);
+                fprintf(out, "\n");
+                break;
+        }
+    }
+}
+
+void ir_free(IRFuncao *f) {
+    if (!f) return;
+    for (int b = 0; b < f->nblocos; b++) free(f->blocos[b].instrs);
+    free(f->blocos);
+    free(f->vals);
+    free(f->lacos);
+    free(f->saida);
+    free(f);
+}
@@ -0,0 +1,81 @@
+#ifndef IR_H
+#define IR_H
+
+#include <stdio.h>
+#include "sintatico.h"
+
+/* -------------------- Representação intermediária (IR) --------------------
+   Grafo de fluxo de controle em forma SSA: cada valor é definido uma única vez,
+   e onde dois caminhos se encontram (fim do if, cabeça do while) aparecem as phis.
+   As variáveis do programa viram "versões" (valores) — não existe load/store.
+
+   Todo valor tem tipo estático (integer = int64, real = double). Os dois
+   operandos de uma operação têm sempre o mesmo tipo: a geração coloca i2f
+   onde a tipagem alarga integer pra real.
+*/
+
+typedef enum {
+    IR_CONST,   /* cte */
+    IR_PARAM,   /* valor inicial da variável cte.i (vem de fora; por padrão 0) */
+    IR_PHI,     /* a = valor vindo de pred[0], b = valor vindo de pred[1] */
+    IR_ADD, IR_SUB, IR_MUL, IR_DIV, IR_NEG,   /* no tipo do próprio valor */
+    IR_I2F,     /* integer -> real */
+    IR_TRUNC,   /* real -> integer, descarta a parte fracionária */
+    IR_EQ, IR_NE, IR_LT, IR_LE, IR_GT, IR_GE  /* comparam no tipo dos operandos, valem integer 0/1 */
+} IROp;
+
+typedef struct {
+    IROp   op;
+    Tipo   tipo;
+    int    bloco;   /* bloco onde está; -1 depois de removido por algum passe */
+    int    a, b;    /* operandos (índices de valores), -1 se não usa */
+    Valor  cte;     /* IR_CONST */
+    int    var;     /* variável de origem (só pro dump), -1 se é temporário */
+    int    pos;     /* byte no fonte (prog->fonte), -1 se não tem */
+} IRValor;
+
+typedef enum { TERM_JMP, TERM_BR, TERM_RET } IRTerm;
+
+/* A geração a partir de if/while garante no máximo 2 predecessores por bloco
+   e nenhuma aresta crítica (o if sem else ganha um bloco vazio). */
+typedef struct {
+    int   *instrs;          /* valores na ordem de execução (phis primeiro) */
+    int    ninstrs, capinstrs;
+    int    pred[2], npred;
+    IRTerm term;
+    int    cond;            /* TERM_BR: valor testado (!= 0 vai pra succ[0]) */
+    int    succ[2];
+} IRBloco;
+
+/* Um while: cabeça, bloco de entrada (preheader) e a faixa de blocos do laço.
+   Os blocos de um laço são criados em sequência, então [primeiro, ultimo] cobre
+   cabeça + corpo inteiro, inclusive laços internos. */
+typedef struct {
+    int cabeca, preheader;
+    int primeiro, ultimo;
+    int pos;
+} IRLaco;
+
+typedef struct {
+    const Programa *prog;
+    IRValor *vals;   int nvals, capvals;
+    IRBloco *blocos; int nblocos, capblocos;
+    IRLaco  *lacos;  int nlacos, caplacos;   /* internos antes dos externos */
+    int     *saida;  /* valor final de cada variável, lido pelo ret */
+} IRFuncao;
+
+IRFuncao *ir_gera(const Programa *prog);
+void      ir_dump(const IRFuncao *f, FILE *out);
+void      ir_free(IRFuncao *f);
+int       ir_conta_instrs(const IRFuncao *f);
+
+/* Calcula op sobre constantes, com a mesma semântica da execução
+   (integer dá a volta em 64 bits, divisão inteira trunca). 't' é o tipo
+   dos operandos. Devolve 0 se não dá pra dobrar (divisão inteira por zero). */
+int       ir_dobra(IROp op, Tipo t, Valor a, Valor b, Valor *res);
+
+/* Divisão inteira que pode derrubar o programa em tempo de execução:
+   não pode ser removida mesmo sem uso, nem executada fora de hora (licm) */
+int       ir_pode_falhar(const IRFuncao *f, int v);
+
+#endif
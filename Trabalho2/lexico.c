@@ -1,217 +1,291 @@
-#include <stdio.h>
-#include <stdlib.h>
-#include <ctype.h>
-#include <string.h>
-#include "lexico.h"
-
-static const char *input;
-static int current_line = 1;
-
-/* Vetor dinâmico
-   Implementação simples pra guardar os tokens sem saber a quantidade exata antes.
-*/
-static void tv_init(TokenVec *v) { v->data=NULL; v->size=v->cap=0; }
-
-static void tv_reserve(TokenVec *v, size_t n){
-    if(n <= v->cap) return;
-    size_t cap = v->cap ? v->cap : 16;
-    while(cap < n) cap *= 2; /* Cresce exponencialmente pra não ficar realocando toda hora */
-    Token *p = realloc(v->data, cap * sizeof(Token));
-    if(!p){ perror("realloc"); exit(1); }
-    v->data=p; v->cap=cap;
-}
-
-static void tv_push(TokenVec *v, Token t){
-    if(v->size+1 > v->cap) tv_reserve(v, v->size+1);
-    v->data[v->size++] = t;
-}
-
-void tv_free(TokenVec *v){ 
-    /* Limpa a sujeira da memória */
-    for(int i=0; i<v->size; i++) {
-        free(v->data[i].lexeme); 
-    }
-    free(v->data); v->data=NULL; v->size=v->cap=0; 
-}
-
-
-/* Lexer */
-
-static void skip_ws_and_newlines(void){
-    while(*input != '\0') {
-        /* Ignora espaços, tabs, e conta as linhas pra ajudar no debug depois */
-        if (*input == ' ' || *input == '\t' || *input == '\n' || *input == '\r') {
-            if (*input == '\n') current_line++;
-            input++;
-            continue;
-        }
-        /* Ignora caracteres de controle estranhos se aparecerem */
-        if ((unsigned char)*input <= 0x1F) {
-            if (*input == '\n') current_line++;
-            input++;
-            continue;
-        }
-        break;
-    }
-}
-
-static int check_keyword(const char *s){
-    if (strcmp(s, "program") == 0) return PROGRAM_TOK;
-    if (strcmp(s, "var") == 0)     return VAR_TOK;
-    if (strcmp(s, "integer") == 0) return INTEGER_TOK;
-    if (strcmp(s, "real") == 0)    return REAL_TOK;
-    if (strcmp(s, "begin") == 0)   return BEGIN_TOK;
-    if (strcmp(s, "end") == 0)     return END_TOK;
-    if (strcmp(s, "if") == 0)      return IF_TOK;
-    if (strcmp(s, "then") == 0)    return THEN_TOK;
-    if (strcmp(s, "else") == 0)    return ELSE_TOK;
-    if (strcmp(s, "while") == 0)   return WHILE_TOK;
-    if (strcmp(s, "do") == 0)      return DO_TOK;
-    return ID; /* Se não for palavra reservada, é variável/ID */
-}
-
-/* Fiz meu próprio strndup pq nem todo compilador/SO (tipo Windows antigo) suporta nativamente.
-*/
-static char *my_strndup(const char *s, size_t n) {
-    char *p = malloc(n + 1);
-    if (!p) return NULL;
-    memcpy(p, s, n);
-    p[n] = '\0';
-    return p;
-}
-
-static Token getToken(void){
-    Token tok = {0, 0.0, NULL, current_line};
-    skip_ws_and_newlines();
-
-    // Acabou o arquivo
-    if(*input=='\0'){ tok.type=END_FILE; tok.line=current_line; return tok; }
-
-    // Identificadores e Palavras Chave
-    if(isalpha((unsigned char)*input)){
-        const char *start = input;
-        /* Vai engolindo caracteres alfanuméricos */
-        while(isalnum((unsigned char)*input) || *input == '_') input++;
-        int len = input - start;
-        char *lex = my_strndup(start, len);
-        tok.type = check_keyword(lex);
-        tok.lexeme = lex;
-        return tok;
-    }
-    
-    // Números
-    if(isdigit((unsigned char)*input)){
-        char *endptr;
-        tok.value = strtod(input, &endptr);
-        int len = endptr - input;
-        tok.lexeme = my_strndup(input, len);
-        input = endptr;
-        tok.type=NUM; 
-        return tok;
-    }
-
-    // Símbolos compostos (tipo :=, <=, etc)
-    if (*input == ':') {
-        input++;
-        if (*input == '=') { tok.type = ASSIGN; input++; } // Achou :=
-        else { tok.type = COLON; } // Só :
-    }
-    else if (*input == '<') {
-        input++;
-        if (*input == '=') { tok.type = LE; input++; } // <=
-        else if (*input == '>') { tok.type = NE; input++; } // <>
-        else { tok.type = LT; } // <
-    }
-    else if (*input == '>') {
-        input++;
-        if (*input == '=') { tok.type = GE; input++; } // >=
-        else { tok.type = GT; } // >
-    }
-    
-    // Símbolos simples
-    else {
-        switch(*input){
-            case '+': tok.type=PLUS; break;
-            case '-': tok.type=MINUS; break;
-            case '*': tok.type=MULT; break;
-            case '/': tok.type=DIV; break;
-            case '(': tok.type=LPAREN; break;
-            case ')': tok.type=RPAREN; break;
-            case ';': tok.type=SEMICOLON; break;
-            case ',': tok.type=COMMA; break;
-            case '=': tok.type=EQ; break;
-            case '.': tok.type=DOT; break;
-            default:
-                fprintf(stderr,"Erro léxico na linha %d: caractere estranho '%c'\n", current_line, *input);
-                exit(1);
-        }
-        input++;
-    }
-
-    /* Aloca lexema pra símbolos simples, senão dá pau na hora de imprimir erro depois */
-    if (!tok.lexeme && tok.type != 0 && tok.type != NUM && tok.type != ID) {
-        tok.lexeme = (char*)malloc(2);
-        tok.lexeme[0] = (char)(tok.type);
-        tok.lexeme[1] = '\0';
-    }
-
-    return tok;
-}
-
-/* Gera o vetorzão com todos os tokens */
-TokenVec tokenize_to_vector(const char *src){
-
-    /* Remove BOM se tiver (aqueles bytes chatos do UTF-8 no início) */
-    if (src && src[0] == (char)0xEF && src[1] == (char)0xBB && src[2] == (char)0xBF) {
-        input = src + 3;
-    } else {
-        input = src;
-    }
-
-    current_line = 1;
-    TokenVec v; tv_init(&v);
-    for(;;){
-        Token t = getToken();
-        tv_push(&v, t);
-        if(t.type == END_FILE) break;
-    }
-    return v;
-}
-
-/* Converte o enum pra string legível (pra debug) */
-const char *token_name(int t){
-    switch(t){
-        case NUM: return "NUMERO";
-        case ID: return "IDENTIFICADOR";
-        case PROGRAM_TOK: return "PROGRAM";
-        case VAR_TOK: return "VAR";
-        case INTEGER_TOK: return "INTEGER";
-        case REAL_TOK: return "REAL";
-        case BEGIN_TOK: return "BEGIN";
-        case END_TOK: return "END";
-        case IF_TOK: return "IF";
-        case THEN_TOK: return "THEN";
-        case ELSE_TOK: return "ELSE";
-        case WHILE_TOK: return "WHILE";
-        case DO_TOK: return "DO";
-        case PLUS: return "+";
-        case MINUS: return "-";
-        case MULT: return "*";
-        case DIV: return "/";
-        case LPAREN: return "(";
-        case RPAREN: return ")";
-        case DOT: return ".";
-        case SEMICOLON: return ";";
-        case COLON: return ":";
-        case COMMA: return ",";
-        case ASSIGN: return ":=";
-        case EQ: return "=";
-        case NE: return "<>";
-        case LT: return "<";
-        case LE: return "<=";
-        case GT: return ">";
-        case GE: return ">=";
-        case END_FILE: return "FIM_DE_ARQUIVO";
-        default: return "TOKEN_DESCONHECIDO";
-    }
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <string.h>
+#include "lexico.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define LEX_SSE2 1
+#endif
+
+static const char *input;
+static const char *inicio;   /* começo do fonte (depois do BOM): pos 0 */
+static Fonte *fonte_atual;
+
+/* Vetor dinâmico
+   Implementação simples pra guardar os tokens sem saber a quantidade exata antes.
+*/
+static void tv_init(TokenVec *v) { v->data=NULL; v->size=v->cap=0; v->fonte=NULL; }
+
+static void tv_reserve(TokenVec *v, size_t n){
+    if(n <= v->cap) return;
+    size_t cap = v->cap ? v->cap : 16;
+    while(cap < n) cap *= 2; /* Cresce exponencialmente pra não ficar realocando toda hora */
+    Token *p = realloc(v->data, cap * sizeof(Token));
+    if(!p){ perror("realloc"); exit(1); }
+    v->data=p; v->cap=cap;
+}
+
+static void tv_push(TokenVec *v, Token t){
+    if(v->size+1 > v->cap) tv_reserve(v, v->size+1);
+    v->data[v->size++] = t;
+}
+
+void tv_free(TokenVec *v){ 
+    /* Limpa a sujeira da memória */
+    for(int i=0; i<v->size; i++) {
+        free(v->data[i].lexeme); 
+    }
+    free(v->data); v->data=NULL; v->size=v->cap=0; 
+    if (v->fonte) { free(v->fonte->quebras); free(v->fonte); v->fonte=NULL; }
+}
+
+
+/* Lexer */
+
+static void skip_ws_and_newlines(void){
+    while(*input != '\0') {
+        /* Ignora espaços, tabs e quebras de linha (a linha sai do índice
+           da Fonte, só quando precisar) */
+        if (*input == ' ' || *input == '\t' || *input == '\n' || *input == '\r') {
+            input++;
+            continue;
+        }
+        /* Ignora caracteres de controle estranhos se aparecerem */
+        if ((unsigned char)*input <= 0x1F) {
+            input++;
+            continue;
+        }
+        break;
+    }
+}
+
+static int check_keyword(const char *s){
+    if (strcmp(s, "program") == 0) return PROGRAM_TOK;
+    if (strcmp(s, "var") == 0)     return VAR_TOK;
+    if (strcmp(s, "integer") == 0) return INTEGER_TOK;
+    if (strcmp(s, "real") == 0)    return REAL_TOK;
+    if (strcmp(s, "begin") == 0)   return BEGIN_TOK;
+    if (strcmp(s, "end") == 0)     return END_TOK;
+    if (strcmp(s, "if") == 0)      return IF_TOK;
+    if (strcmp(s, "then") == 0)    return THEN_TOK;
+    if (strcmp(s, "else") == 0)    return ELSE_TOK;
+    if (strcmp(s, "while") == 0)   return WHILE_TOK;
+    if (strcmp(s, "do") == 0)      return DO_TOK;
+    return ID; /* Se não for palavra reservada, é variável/ID */
+}
+
+/* Fiz meu próprio strndup pq nem todo compilador/SO (tipo Windows antigo) suporta nativamente.
+*/
+static char *my_strndup(const char *s, size_t n) {
+    char *p = malloc(n + 1);
+    if (!p) return NULL;
+    memcpy(p, s, n);
+    p[n] = '\0';
+    return p;
+}
+
+static Token getToken(void){
+    Token tok = {0, 0.0, NULL, 0};
+    skip_ws_and_newlines();
+    tok.pos = (int)(input - inicio); /* onde o token começa, não onde o anterior terminou */
+
+    // Acabou o arquivo
+    if(*input=='\0'){ tok.type=END_FILE; return tok; }
+
+    // Identificadores e Palavras Chave
+    if(isalpha((unsigned char)*input)){
+        const char *start = input;
+        /* Vai engolindo caracteres alfanuméricos */
+        while(isalnum((unsigned char)*input) || *input == '_') input++;
+        int len = input - start;
+        char *lex = my_strndup(start, len);
+        tok.type = check_keyword(lex);
+        tok.lexeme = lex;
+        return tok;
+    }
+    
+    // Números
+    if(isdigit((unsigned char)*input)){
+        char *endptr;
+        tok.value = strtod(input, &endptr);
+        int len = endptr - input;
+        tok.lexeme = my_strndup(input, len);
+        input = endptr;
+        tok.type=NUM; 
+        return tok;
+    }
+
+    // Símbolos compostos (tipo :=, <=, etc)
+    if (*input == ':') {
+        input++;
+        if (*input == '=') { tok.type = ASSIGN; input++; } // Achou :=
+        else { tok.type = COLON; } // Só :
+    }
+    else if (*input == '<') {
+        input++;
+        if (*input == '=') { tok.type = LE; input++; } // <=
+        else if (*input == '>') { tok.type = NE; input++; } // <>
+        else { tok.type = LT; } // <
+    }
+    else if (*input == '>') {
+        input++;
+        if (*input == '=') { tok.type = GE; input++; } // >=
+        else { tok.type = GT; } // >
+    }
+    
+    // Símbolos simples
+    else {
+        switch(*input){
+            case '+': tok.type=PLUS; break;
+            case '-': tok.type=MINUS; break;
+            case '*': tok.type=MULT; break;
+            case '/': tok.type=DIV; break;
+            case '(': tok.type=LPAREN; break;
+            case ')': tok.type=RPAREN; break;
+            case ';': tok.type=SEMICOLON; break;
+            case ',': tok.type=COMMA; break;
+            case '=': tok.type=EQ; break;
+            case '.': tok.type=DOT; break;
+            default:
+                fprintf(stderr,"Erro léxico na linha %d, coluna %d: caractere estranho '%c'\n",
+                        LINHA_COLUNA(fonte_atual, tok.pos), *input);
+                exit(1);
+        }
+        input++;
+    }
+
+    /* Aloca lexema pra símbolos simples, senão dá pau na hora de imprimir erro depois */
+    if (!tok.lexeme && tok.type != 0 && tok.type != NUM && tok.type != ID) {
+        tok.lexeme = (char*)malloc(2);
+        tok.lexeme[0] = (char)(tok.type);
+        tok.lexeme[1] = '\0';
+    }
+
+    return tok;
+}
+
+/* === Linha e coluna sob demanda === */
+
+static void guarda_quebra(Fonte *f, int *cap, int pos) {
+    if (f->nquebras == *cap) {
+        *cap = *cap ? *cap * 2 : 256;
+        f->quebras = realloc(f->quebras, *cap * sizeof(int));
+        if (!f->quebras) { perror("realloc"); exit(1); }
+    }
+    f->quebras[f->nquebras++] = pos;
+}
+
+/* Acha todos os '\n' do fonte. Com SSE2 compara 16 bytes por vez e só
+   olha byte a byte nos blocos que têm quebra. */
+static void monta_indice(Fonte *f) {
+    const char *s = f->src;
+    int n = (int)strlen(s), i = 0, cap = 0;
+    f->nquebras = 0;
+#ifdef LEX_SSE2
+    const __m128i nl = _mm_set1_epi8('\n');
+    for (; i + 16 <= n; i += 16) {
+        unsigned m = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(s + i)), nl));
+        while (m) {
+#ifdef __GNUC__
+            int b = __builtin_ctz(m);
+#else
+            int b = 0;
+            while (!(m & (1u << b))) b++;
+#endif
+            guarda_quebra(f, &cap, i + b);
+            m &= m - 1;
+        }
+    }
+#endif
+    for (; i < n; i++)
+        if (s[i] == '\n') guarda_quebra(f, &cap, i);
+}
+
+/* Quantas quebras vêm antes de pos (busca binária) */
+static int quebras_antes(Fonte *f, int pos) {
+    if (f->nquebras < 0) monta_indice(f);
+    int lo = 0, hi = f->nquebras;
+    while (lo < hi) {
+        int meio = (lo + hi) / 2;
+        if (f->quebras[meio] < pos) lo = meio + 1;
+        else hi = meio;
+    }
+    return lo;
+}
+
+int fonte_linha(Fonte *f, int pos) {
+    if (!f || pos < 0) return 0;
+    return quebras_antes(f, pos) + 1;
+}
+
+int fonte_coluna(Fonte *f, int pos) {
+    if (!f || pos < 0) return 0;
+    int k = quebras_antes(f, pos);
+    return k == 0 ? pos + 1 : pos - f->quebras[k - 1];
+}
+
+/* Gera o vetorzão com todos os tokens */
+TokenVec tokenize_to_vector(const char *src){
+
+    /* Remove BOM se tiver (aqueles bytes chatos do UTF-8 no início) */
+    if (src && src[0] == (char)0xEF && src[1] == (char)0xBB && src[2] == (char)0xBF) {
+        input = src + 3;
+    } else {
+        input = src;
+    }
+
+    inicio = input;
+    TokenVec v; tv_init(&v);
+    v.fonte = malloc(sizeof(Fonte));
+    if (!v.fonte) { perror("malloc"); exit(1); }
+    v.fonte->src = inicio;
+    v.fonte->quebras = NULL;
+    v.fonte->nquebras = -1;
+    fonte_atual = v.fonte;
+    for(;;){
+        Token t = getToken();
+        tv_push(&v, t);
+        if(t.type == END_FILE) break;
+    }
+    return v;
+}
+
+/* Converte o enum pra string legível (pra debug) */
+const char *token_name(int t){
+    switch(t){
+        case NUM: return "NUMERO";
+        case ID: return "IDENTIFICADOR";
+        case PROGRAM_TOK: return "PROGRAM";
+        case VAR_TOK: return "VAR";
+        case INTEGER_TOK: return "INTEGER";
+        case REAL_TOK: return "REAL";
+        case BEGIN_TOK: return "BEGIN";
+        case END_TOK: return "END";
+        case IF_TOK: return "IF";
+        case THEN_TOK: return "THEN";
+        case ELSE_TOK: return "ELSE";
+        case WHILE_TOK: return "WHILE";
+        case DO_TOK: return "DO";
+        case PLUS: return "+";
+        case MINUS: return "-";
+        case MULT: return "*";
+        case DIV: return "/";
+        case LPAREN: return "(";
+        case RPAREN: return ")";
+        case DOT: return ".";
+        case SEMICOLON: return ";";
+        case COLON: return ":";
+        case COMMA: return ",";
+        case ASSIGN: return ":=";
+        case EQ: return "=";
+        case NE: return "<>";
+        case LT: return "<";
+        case LE: return "<=";
+        case GT: return ">";
+        case GE: return ">=";
+        case END_FILE: return "FIM_DE_ARQUIVO";
+        default: return "TOKEN_DESCONHECIDO";
+    }
 }
\ No newline at end of file
@@ -1,65 +1,81 @@
-#ifndef LEXICO_H
-#define LEXICO_H
-
-/* -------------------- Definições de tokens -------------------- */
-
-// Terminais já existentes para Expressões
-#define NUM    256
-#define PLUS   '+'
-#define MINUS  '-'
-#define MULT   '*'
-#define DIV    '/'
-#define LPAREN '('
-#define RPAREN ')'
-
-// Novos tokens para MicroPascal (Palavras Reservadas e Símbolos)
-#define ID               257 
-#define PROGRAM_TOK      258 
-#define VAR_TOK          259 
-#define INTEGER_TOK      260 
-#define REAL_TOK         261 
-#define BEGIN_TOK        262 
-#define END_TOK          263 
-#define IF_TOK           264 
-#define THEN_TOK         265 
-#define ELSE_TOK         266 
-#define WHILE_TOK        267 
-#define DO_TOK           268 
-
-// Símbolos de Pontuação e Operadores
-#define DOT              '.'   
-#define SEMICOLON        ';'   
-#define COLON            ':'  
-#define COMMA            ','  
-#define ASSIGN           269   
-
-// Tokens de Relação (adaptados da gramática MicroPascal)
-#define EQ               300   // =
-#define NE               301   // <> (Não igual)
-#define LT               '<'   // Menor que
-#define LE               302   // <= (Menor ou igual)
-#define GT               '>'   // Maior que
-#define GE               303   // >= (Maior ou igual)
-
-#define END_FILE         0     // Fim do arquivo
-
-typedef struct {
-    int type;
-    double value;   
-    char *lexeme;   
-    int line;       
-} Token;
-
-/* Estrutura de vetor de tokens */
-typedef struct {
-    Token *data;
-    int size;
-    int cap;
-} TokenVec;
-
-/* -------------------- Assinaturas -------------------- */
-TokenVec tokenize_to_vector(const char *src);
-void tv_free(TokenVec *v);
-const char *token_name(int t); 
-
+#ifndef LEXICO_H
+#define LEXICO_H
+
+/* -------------------- Definições de tokens -------------------- */
+
+// Terminais já existentes para Expressões
+#define NUM    256
+#define PLUS   '+'
+#define MINUS  '-'
+#define MULT   '*'
+#define DIV    '/'
+#define LPAREN '('
+#define RPAREN ')'
+
+// Novos tokens para MicroPascal (Palavras Reservadas e Símbolos)
+#define ID               257 
+#define PROGRAM_TOK      258 
+#define VAR_TOK          259 
+#define INTEGER_TOK      260 
+#define REAL_TOK         261 
+#define BEGIN_TOK        262 
+#define END_TOK          263 
+#define IF_TOK           264 
+#define THEN_TOK         265 
+#define ELSE_TOK         266 
+#define WHILE_TOK        267 
+#define DO_TOK           268 
+
+// Símbolos de Pontuação e Operadores
+#define DOT              '.'   
+#define SEMICOLON        ';'   
+#define COLON            ':'  
+#define COMMA            ','  
+#define ASSIGN           269   
+
+// Tokens de Relação (adaptados da gramática MicroPascal)
+#define EQ               300   // =
+#define NE               301   // <> (Não igual)
+#define LT               '<'   // Menor que
+#define LE               302   // <= (Menor ou igual)
+#define GT               '>'   // Maior que
+#define GE               303   // >= (Maior ou igual)
+
+#define END_FILE         0     // Fim do arquivo
+
+typedef struct {
+    int type;
+    double value;   
+    char *lexeme;   
+    int pos;        /* byte onde o token começa no fonte (linha/coluna: fonte_linha...) */
+} Token;
+
+/* Fonte com índice de quebras de linha. O índice só é montado na primeira
+   vez que alguém pede linha/coluna (mensagem de erro, perfil, dump), então
+   o lexer não gasta nada contando linha. Posição -1 = sem posição. */
+typedef struct {
+    const char *src;
+    int        *quebras;    /* offset de cada '\n', em ordem */
+    int         nquebras;   /* -1 enquanto não montou */
+} Fonte;
+
+int fonte_linha(Fonte *f, int pos);    /* a partir de 1; 0 se pos < 0 */
+int fonte_coluna(Fonte *f, int pos);   /* a partir de 1, em bytes */
+
+/* Pra usar direto no printf: "%d:%d:..." */
+#define LINHA_COLUNA(f, pos) fonte_linha((f), (pos)), fonte_coluna((f), (pos))
+
+/* Estrutura de vetor de tokens */
+typedef struct {
+    Token *data;
+    int size;
+    int cap;
+    Fonte *fonte;   /* pra onde apontam os pos dos tokens */
+} TokenVec;
+
+/* -------------------- Assinaturas -------------------- */
+TokenVec tokenize_to_vector(const char *src);
+void tv_free(TokenVec *v);
+const char *token_name(int t); 
+
 #endif
\ No newline at end of file
@@ -0,0 +1,440 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lote.h"
+#include "tipos.h"
+#include "rpn.h"
+
+/* AVX2 só em x86 com GCC/Clang. As funções vetoriais são compiladas com
+   target("avx2"), então não precisa de -mavx2 no build, e a escolha é
+   feita em tempo de execução (__builtin_cpu_supports). */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LOTE_AVX2 1
+#include <immintrin.h>
+#define ALVO_AVX2 __attribute__((target("avx2")))
+#endif
+
+#define K LOTE_PEDACO
+#define U(x) ((unsigned long long)(x))
+
+static void *aloca(size_t n) {
+    void *m = calloc(1, n ? n : 1);
+    if (!m) { perror("calloc"); exit(1); }
+    return m;
+}
+
+/* === Kernels ===
+   Cada um processa n pistas (n é sempre LOTE_PEDACO, múltiplo de 4).
+   Relações escrevem 0/1 como integer; máscaras são 0 / -1 (todos os bits). */
+
+typedef void (*Op2)(Valor *d, const Valor *a, const Valor *b, int n);
+
+typedef struct {
+    Op2 arit[2][3];   /* [tipo][add, sub, mul] */
+    Op2 div_r;
+    Op2 rel[2][6];    /* [tipo dos operandos][eq, ne, lt, le, gt, ge] */
+    Op2 mistura;      /* d = b ? a : d   (b é máscara) */
+    Op2 e_verdade;    /* d = b & (a != 0) */
+    Op2 e_falso;      /* d = b & (a == 0) */
+    int (*algum)(const Valor *m, int n);
+} Kernels;
+
+/* --- Versão escalar (uma pista por iteração) --- */
+
+#define K2(nome, campo, expr) \
+    static void nome(Valor *d, const Valor *a, const Valor *b, int n) { \
+        for (int i = 0; i < n; i++) d[i].campo = (expr); \
+    }
+
+K2(e_add_i, i, (long long)(U(a[i].i) + U(b[i].i)))
+K2(e_sub_i, i, (long long)(U(a[i].i) - U(b[i].i)))
+K2(e_mul_i, i, (long long)(U(a[i].i) * U(b[i].i)))
+K2(e_add_r, f, a[i].f + b[i].f)
+K2(e_sub_r, f, a[i].f - b[i].f)
+K2(e_mul_r, f, a[i].f * b[i].f)
+K2(e_div_r, f, a[i].f / b[i].f)
+K2(e_eq_i, i, a[i].i == b[i].i)
+K2(e_ne_i, i, a[i].i != b[i].i)
+K2(e_lt_i, i, a[i].i <  b[i].i)
+K2(e_le_i, i, a[i].i <= b[i].i)
+K2(e_gt_i, i, a[i].i >  b[i].i)
+K2(e_ge_i, i, a[i].i >= b[i].i)
+K2(e_eq_r, i, a[i].f == b[i].f)
+K2(e_ne_r, i, a[i].f != b[i].f)
+K2(e_lt_r, i, a[i].f <  b[i].f)
+K2(e_le_r, i, a[i].f <= b[i].f)
+K2(e_gt_r, i, a[i].f >  b[i].f)
+K2(e_ge_r, i, a[i].f >= b[i].f)
+K2(e_mistura, i, b[i].i ? a[i].i : d[i].i)
+K2(e_verdade, i, b[i].i & -(long long)(a[i].i != 0))
+K2(e_falso, i, b[i].i & -(long long)(a[i].i == 0))
+
+static int e_algum(const Valor *m, int n) {
+    long long r = 0;
+    for (int i = 0; i < n; i++) r |= m[i].i;
+    return r != 0;
+}
+
+static const Kernels escalar = {
+    { { e_add_i, e_sub_i, e_mul_i }, { e_add_r, e_sub_r, e_mul_r } },
+    e_div_r,
+    { { e_eq_i, e_ne_i, e_lt_i, e_le_i, e_gt_i, e_ge_i },
+      { e_eq_r, e_ne_r, e_lt_r, e_le_r, e_gt_r, e_ge_r } },
+    e_mistura, e_verdade, e_falso, e_algum
+};
+
+/* --- Versão AVX2 (4 pistas de 64 bits por instrução) --- */
+#ifdef LOTE_AVX2
+
+#define LI(p) _mm256_loadu_si256((const __m256i *)(p))
+#define SI(p, x) _mm256_storeu_si256((__m256i *)(p), (x))
+#define LD(p) _mm256_loadu_pd((const double *)(p))
+#define SD(p, x) _mm256_storeu_pd((double *)(p), (x))
+
+#define V2I(nome, expr) \
+    ALVO_AVX2 static void nome(Valor *d, const Valor *a, const Valor *b, int n) { \
+        for (int i = 0; i < n; i += 4) { __m256i x = LI(a + i), y = LI(b + i); SI(d + i, (expr)); } \
+    }
+#define V2D(nome, expr) \
+    ALVO_AVX2 static void nome(Valor *d, const Valor *a, const Valor *b, int n) { \
+        for (int i = 0; i < n; i += 4) { __m256d x = LD(a + i), y = LD(b + i); SD(d + i, (expr)); } \
+    }
+/* Relação real: compara e transforma a máscara em 0/1 */
+#define V2C(nome, pred) \
+    V2I(nome, _mm256_srli_epi64(_mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(x), _mm256_castsi256_pd(y), pred)), 63))
+
+/* AVX2 não tem multiplicação de 64 bits: monta com produtos de 32 bits */
+ALVO_AVX2 static __m256i mul64(__m256i x, __m256i y) {
+    __m256i lo = _mm256_mul_epu32(x, y);
+    __m256i cruz = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(x, 32), y),
+                                    _mm256_mul_epu32(x, _mm256_srli_epi64(y, 32)));
+    return _mm256_add_epi64(lo, _mm256_slli_epi64(cruz, 32));
+}
+
+/* 0/1 a partir de máscara; "não" inverte o 0/1 */
+#define UM(m)    _mm256_srli_epi64((m), 63)
+#define NAO(m)   _mm256_xor_si256(UM(m), _mm256_set1_epi64x(1))
+
+V2I(v_add_i, _mm256_add_epi64(x, y))
+V2I(v_sub_i, _mm256_sub_epi64(x, y))
+V2I(v_mul_i, mul64(x, y))
+V2D(v_add_r, _mm256_add_pd(x, y))
+V2D(v_sub_r, _mm256_sub_pd(x, y))
+V2D(v_mul_r, _mm256_mul_pd(x, y))
+V2D(v_div_r, _mm256_div_pd(x, y))
+V2I(v_eq_i, UM(_mm256_cmpeq_epi64(x, y)))
+V2I(v_ne_i, NAO(_mm256_cmpeq_epi64(x, y)))
+V2I(v_lt_i, UM(_mm256_cmpgt_epi64(y, x)))
+V2I(v_le_i, NAO(_mm256_cmpgt_epi64(x, y)))
+V2I(v_gt_i, UM(_mm256_cmpgt_epi64(x, y)))
+V2I(v_ge_i, NAO(_mm256_cmpgt_epi64(y, x)))
+V2C(v_eq_r, _CMP_EQ_OQ)
+V2C(v_ne_r, _CMP_NEQ_UQ)
+V2C(v_lt_r, _CMP_LT_OQ)
+V2C(v_le_r, _CMP_LE_OQ)
+V2C(v_gt_r, _CMP_GT_OQ)
+V2C(v_ge_r, _CMP_GE_OQ)
+
+ALVO_AVX2 static void v_mistura(Valor *d, const Valor *a, const Valor *b, int n) {
+    for (int i = 0; i < n; i += 4) {
+        __m256i m = LI(b + i);
+        SI(d + i, _mm256_or_si256(_mm256_and_si256(m, LI(a + i)), _mm256_andnot_si256(m, LI(d + i))));
+    }
+}
+
+ALVO_AVX2 static void v_verdade(Valor *d, const Valor *a, const Valor *b, int n) {
+    for (int i = 0; i < n; i += 4) {
+        __m256i zero = _mm256_cmpeq_epi64(LI(a + i), _mm256_setzero_si256());
+        SI(d + i, _mm256_andnot_si256(zero, LI(b + i)));
+    }
+}
+
+ALVO_AVX2 static void v_falso(Valor *d, const Valor *a, const Valor *b, int n) {
+    for (int i = 0; i < n; i += 4) {
+        __m256i zero = _mm256_cmpeq_epi64(LI(a + i), _mm256_setzero_si256());
+        SI(d + i, _mm256_and_si256(zero, LI(b + i)));
+    }
+}
+
+ALVO_AVX2 static int v_algum(const Valor *m, int n) {
+    __m256i r = _mm256_setzero_si256();
+    for (int i = 0; i < n; i += 4) r = _mm256_or_si256(r, LI(m + i));
+    return !_mm256_testz_si256(r, r);
+}
+
+static const Kernels avx2 = {
+    { { v_add_i, v_sub_i, v_mul_i }, { v_add_r, v_sub_r, v_mul_r } },
+    v_div_r,
+    { { v_eq_i, v_ne_i, v_lt_i, v_le_i, v_gt_i, v_ge_i },
+      { v_eq_r, v_ne_r, v_lt_r, v_le_r, v_gt_r, v_ge_r } },
+    v_mistura, v_verdade, v_falso, v_algum
+};
+
+#endif /* LOTE_AVX2 */
+
+int lote_tem_avx2(void) {
+#ifdef LOTE_AVX2
+    return __builtin_cpu_supports("avx2");
+#else
+    return 0;
+#endif
+}
+
+/* === Execução sobre a forma pós-fixa ===
+   As expressões vêm de Comando.rpn (o programa tem que ter sido lido com
+   parse_program_rpn); a árvore das expressões não é visitada aqui. */
+
+typedef struct {
+    Lote *l;
+    const Kernels *k;
+    int   base;        /* primeira instância do pedaço atual */
+    Valor *arena;      /* buffers temporários de K pistas, usados em pilha */
+    int   topo, nslots;
+    const Valor **pilha;   /* pilha da avaliação: aponta pra coluna ou pra buffer */
+} Exec;
+
+static Valor *tmp(Exec *x) {
+    if (x->topo >= x->nslots) {
+        fprintf(stderr, "Erro: lote sem espaco temporario\n");
+        exit(1);
+    }
+    return x->arena + (size_t)(x->topo++) * K;
+}
+
+/* Quantos buffers temporários cada construção usa ao mesmo tempo: uma
+   expressão usa um por posição da pilha, e a condição mais dois */
+static int slots_cmd(const Comando *c) {
+    int maior = 0;
+    for (; c; c = c->prox) {
+        int s = 0;
+        switch (c->kind) {
+            case CMD_ATRIB:    s = (int)c->rpn.pilha + 1; break;
+            case CMD_COMPOSTO: s = slots_cmd(c->corpo); break;
+            case CMD_IF: {
+                int a = slots_cmd(c->corpo), b = slots_cmd(c->senao);
+                s = (int)c->rpn.pilha + 4 + (a > b ? a : b);
+                break;
+            }
+            case CMD_WHILE: s = 1 + (int)c->rpn.pilha + 2 + slots_cmd(c->corpo); break;
+        }
+        if (s > maior) maior = s;
+    }
+    return maior;
+}
+
+/* Maior pilha entre as expressões; também confere que todas têm RPN */
+static int pilha_cmd(const Comando *c) {
+    int maior = 0;
+    for (; c; c = c->prox) {
+        int s = 0;
+        if (c->kind == CMD_COMPOSTO) {
+            s = pilha_cmd(c->corpo);
+        } else {
+            if (c->rpn.n == 0) {
+                fprintf(stderr, "Erro: o lote precisa do programa lido com parse_program_rpn\n");
+                exit(1);
+            }
+            s = (int)c->rpn.pilha;
+            int a = pilha_cmd(c->corpo), b = pilha_cmd(c->senao);
+            if (a > s) s = a;
+            if (b > s) s = b;
+        }
+        if (s > maior) maior = s;
+    }
+    return maior;
+}
+
+static const Valor *converte(Exec *x, const Valor *a, Tipo de, Tipo para) {
+    if (de == para) return a;
+    Valor *d = tmp(x);
+    if (para == TIPO_REAL) for (int i = 0; i < K; i++) d[i].f = (double)a[i].i;
+    else                   for (int i = 0; i < K; i++) d[i].i = trunca_real(a[i].f);
+    return d;
+}
+
+/* Mesmo laço do rpn_avalia, só que cada posição da pilha é um pedaço
+   inteiro. A posição j tem o buffer buf + j*K: folha constante e resultado
+   de operação vão pra ele, variável só aponta pra coluna. Os kernels são
+   pista a pista, então escrever no buffer de um operando é seguro. */
+static const Valor *avalia(Exec *x, RpnExpr e, const Valor *m) {
+    const Rpn *rpn = &x->l->prog->rpn;
+    Valor *buf = x->arena + (size_t)x->topo * K;
+    const Valor **p = x->pilha;
+    int topo = 0;
+    for (uint32_t j = 0; j < e.pilha; j++) tmp(x);   /* reserva os buffers */
+
+    for (const RpnNo *n = rpn->nos + e.ini, *fim = n + e.n; n < fim; n++) {
+        if (n->op == RPN_NUM) {
+            Valor *d = buf + (size_t)topo * K;
+            for (int i = 0; i < K; i++) d[i] = rpn->ctes[n->arg];
+            p[topo++] = d;
+            continue;
+        }
+        if (n->op == RPN_VAR) {
+            p[topo++] = x->l->col[n->arg] + x->base;   /* lê direto da coluna */
+            continue;
+        }
+
+        if (n->op == RPN_NEG) {
+            Valor *d = buf + (size_t)(topo - 1) * K;
+            const Valor *a = p[topo - 1];
+            if (n->tipo == TIPO_INTEGER) for (int i = 0; i < K; i++) d[i].i = (long long)(0 - U(a[i].i));
+            else                         for (int i = 0; i < K; i++) d[i].f = -a[i].f;
+            p[topo - 1] = d;
+            continue;
+        }
+
+        const Valor *b = p[--topo], *a = p[topo - 1];
+        Valor *d = buf + (size_t)(topo - 1) * K;   /* o resultado fica no lugar do operando esquerdo */
+        if (n->conv & RPN_CONV_A) {
+            for (int i = 0; i < K; i++) d[i].f = (double)a[i].i;
+            a = d;
+        }
+        if (n->conv & RPN_CONV_B) {
+            Valor *db = buf + (size_t)topo * K;
+            for (int i = 0; i < K; i++) db[i].f = (double)b[i].i;
+            b = db;
+        }
+
+        if (n->op >= RPN_EQ) {
+            x->k->rel[n->tipo][n->op - RPN_EQ](d, a, b, K);
+        } else if (n->op == RPN_DIV && n->tipo == TIPO_INTEGER) {
+            /* Sem divisão inteira vetorial; e só as pistas ativas podem falhar */
+            for (int i = 0; i < K; i++) {
+                if (!m[i].i) { d[i].i = 0; continue; }
+                if (b[i].i == 0) {
+                    fprintf(stderr, "%d:%d:divisao por zero (instancia %d).\n",
+                            LINHA_COLUNA(x->l->prog->fonte, (int)n->arg), x->base + i);
+                    exit(EXIT_FAILURE);
+                }
+                d[i].i = div_inteira(a[i].i, b[i].i);
+            }
+        } else if (n->op == RPN_DIV) {
+            x->k->div_r(d, a, b, K);
+        } else {
+            x->k->arit[n->tipo][n->op - RPN_ADD](d, a, b, K);
+        }
+        p[topo - 1] = d;
+    }
+    return p[0];
+}
+
+/* Condição como 0/1 integer (real vira x <> 0.0) */
+static const Valor *avalia_cond(Exec *x, RpnExpr e, const Valor *m) {
+    const Valor *c = avalia(x, e, m);
+    if (rpn_tipo(&x->l->prog->rpn, e) == TIPO_INTEGER) return c;
+    Valor *zero = tmp(x), *d = tmp(x);
+    memset(zero, 0, K * sizeof(Valor));
+    x->k->rel[TIPO_REAL][RPN_NE - RPN_EQ](d, c, zero, K);
+    return d;
+}
+
+static void executa(Exec *x, const Comando *c, const Valor *m) {
+    int marca = x->topo;
+    switch (c->kind) {
+        case CMD_ATRIB: {
+            Tipo tv = x->l->prog->vars[c->var].tipo;
+            const Valor *v = converte(x, avalia(x, c->rpn, m), rpn_tipo(&x->l->prog->rpn, c->rpn), tv);
+            x->k->mistura(x->l->col[c->var] + x->base, v, m, K);
+            break;
+        }
+        case CMD_COMPOSTO:
+            for (const Comando *s = c->corpo; s; s = s->prox) executa(x, s, m);
+            break;
+        case CMD_IF: {
+            const Valor *cond = avalia_cond(x, c->rpn, m);
+            Valor *sim = tmp(x), *nao = tmp(x);
+            x->k->e_verdade(sim, cond, m, K);
+            x->k->e_falso(nao, cond, m, K);
+            if (x->k->algum(sim, K)) executa(x, c->corpo, sim);
+            if (c->senao && x->k->algum(nao, K)) executa(x, c->senao, nao);
+            break;
+        }
+        case CMD_WHILE: {
+            Valor *ativo = tmp(x);
+            memcpy(ativo, m, K * sizeof(Valor));
+            for (;;) {
+                int marca_cond = x->topo;
+                const Valor *cond = avalia_cond(x, c->rpn, ativo);
+                x->k->e_verdade(ativo, cond, ativo, K);  /* pista que saiu não volta */
+                x->topo = marca_cond;
+                if (!x->k->algum(ativo, K)) break;
+                executa(x, c->corpo, ativo);
+            }
+            break;
+        }
+    }
+    x->topo = marca;
+}
+
+void lote_executa(Lote *l, int simd) {
+    Exec x;
+    x.l = l;
+    x.k = &escalar;
+#ifdef LOTE_AVX2
+    if (simd && lote_tem_avx2()) x.k = &avx2;
+#else
+    (void)simd;
+#endif
+    x.pilha = aloca((size_t)(pilha_cmd(l->prog->corpo) + 1) * sizeof(Valor *));
+    x.nslots = 1 + slots_cmd(l->prog->corpo);
+    x.arena = aloca((size_t)x.nslots * K * sizeof(Valor));
+    x.topo = 0;
+
+    Valor *mascara = tmp(&x);
+    for (x.base = 0; x.base < l->cap; x.base += K) {
+        /* Pistas além de n (o enchimento do último pedaço) ficam desligadas */
+        for (int i = 0; i < K; i++) mascara[i].i = (x.base + i < l->n) ? -1 : 0;
+        executa(&x, l->prog->corpo, mascara);
+    }
+    free(x.arena);
+    free(x.pilha);
+}
+
+/* === Criação e estado inicial === */
+
+Lote *lote_novo(const Programa *prog, int n) {
+    Lote *l = aloca(sizeof(Lote));
+    l->prog = prog;
+    l->n = n;
+    l->cap = (n + K - 1) / K * K;
+    l->col = aloca(prog->nvars * sizeof(Valor *));
+    for (int v = 0; v < prog->nvars; v++) l->col[v] = aloca((size_t)l->cap * sizeof(Valor));
+    return l;
+}
+
+void lote_free(Lote *l) {
+    if (!l) return;
+    for (int v = 0; v < l->prog->nvars; v++) free(l->col[v]);
+    free(l->col);
+    free(l);
+}
+
+int lote_varia(Lote *l, const char *spec) {
+    const char *igual = strchr(spec, '=');
+    if (!igual) return 1;
+
+    char nome[128];
+    size_t len = (size_t)(igual - spec);
+    if (len >= sizeof nome) return 1;
+    memcpy(nome, spec, len);
+    nome[len] = '\0';
+
+    int v = busca_variavel(l->prog, nome);
+    if (v < 0) return 1;
+
+    char *fim;
+    const char *ini = igual + 1;
+    if (l->prog->vars[v].tipo == TIPO_INTEGER) {
+        long long a = strtoll(ini, &fim, 10), passo = 0;
+        if (*fim == ':') passo = strtoll(fim + 1, &fim, 10);
+        if (*fim) return 1;
+        for (int i = 0; i < l->n; i++) l->col[v][i].i = (long long)(U(a) + U(passo) * U(i));
+    } else {
+        double a = strtod(ini, &fim), passo = 0.0;
+        if (*fim == ':') passo = strtod(fim + 1, &fim);
+        if (*fim) return 1;
+        for (int i = 0; i < l->n; i++) l->col[v][i].f = a + passo * i;
+    }
+    return 0;
+}
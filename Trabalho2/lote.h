@@ -0,0 +1,41 @@
+#ifndef LOTE_H
+#define LOTE_H
+
+#include "sintatico.h"
+#include "ir.h"
+
+/* -------------------- Execução em lote --------------------
+   Roda o mesmo programa sobre muitos estados iniciais de uma vez.
+   Cada variável vira uma coluna (estrutura de vetores): col[v][i] é o valor
+   da variável v na instância i. Os comandos são percorridos pela árvore de
+   Comando, mas as expressões são avaliadas da forma pós-fixa (Comando.rpn,
+   então o programa tem que vir de parse_program_rpn), um pedaço de
+   LOTE_PEDACO instâncias por vez; cada nó da expressão é calculado pro
+   pedaço inteiro (4 pistas por instrução com AVX2).
+
+   if/while com condição diferente em cada instância usam máscara por pista:
+   o then roda com as pistas onde a condição deu verdadeiro, o else com o
+   resto, e o while repete até todas as pistas do pedaço saírem.
+*/
+
+#define LOTE_PEDACO 256
+
+typedef struct {
+    const Programa *prog;
+    int     n;        /* instâncias */
+    int     cap;      /* n arredondado pra múltiplo de LOTE_PEDACO */
+    Valor **col;      /* col[v][i]; entra o estado inicial, sai o final */
+} Lote;
+
+Lote *lote_novo(const Programa *prog, int n);
+void  lote_free(Lote *l);
+
+/* "nome=inicio:passo": instância i começa com nome = inicio + i*passo.
+   Devolve 0 se deu certo. */
+int   lote_varia(Lote *l, const char *spec);
+
+/* simd = 0 usa laços escalares; 1 usa AVX2 se a CPU tiver */
+void  lote_executa(Lote *l, int simd);
+int   lote_tem_avx2(void);
+
+#endif
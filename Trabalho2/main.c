@@ -1,50 +1,213 @@
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include "lexico.h"
-#include "sintatico.h"
-
-/* Lê o arquivo do disco pra RAM de uma vez */
-char *read_file(const char *path) {
-    FILE *f = fopen(path, "rb");
-    if (!f) {
-        fprintf(stderr, "Erro: não consegui abrir '%s'\n", path);
-        exit(1);
-    }
-
-    /* Vai pro fim do arquivo pra pegar o tamanho */
-    fseek(f, 0, SEEK_END);
-    long size = ftell(f);
-    rewind(f);
-
-    char *buffer = malloc(size + 1);
-    if (!buffer) {
-        fprintf(stderr, "Erro: faltou memória pra ler o arquivo\n");
-        exit(1);
-    }
-
-    fread(buffer, 1, size, f);
-    buffer[size] = '\0'; /* Fecha a string */
-    fclose(f);
-    return buffer;
-}
-
-int main(int argc, char **argv) {
-
-    if (argc < 2) {
-        printf("Uso: %s <arquivo>\n", argv[0]);
-        return 1;
-    }
-
-    char *src = read_file(argv[1]);
-
-    /* Passa o scanner e depois o parser */
-    TokenVec tv = tokenize_to_vector(src);
-    parse_program(&tv);
-    
-    /* Faxina na saída */
-    tv_free(&tv);
-    free(src);
-    
-    return 0;
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lexico.h"
+#include "sintatico.h"
+#include "ir.h"
+#include "otimizador.h"
+#include "interpretador.h"
+#include "gerador_c.h"
+#include "bench.h"
+#include "perfil.h"
+#include "escalonador.h"
+
+/* Lê o arquivo do disco pra RAM de uma vez */
+char *read_file(const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "Erro: não consegui abrir '%s'\n", path);
+        exit(1);
+    }
+
+    /* Vai pro fim do arquivo pra pegar o tamanho */
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    rewind(f);
+
+    char *buffer = malloc(size + 1);
+    if (!buffer) {
+        fprintf(stderr, "Erro: faltou memória pra ler o arquivo\n");
+        exit(1);
+    }
+
+    fread(buffer, 1, size, f);
+    buffer[size] = '\0'; /* Fecha a string */
+    fclose(f);
+    return buffer;
+}
+
+static void uso(const char *prog) {
+    printf("Uso: %s [opcoes] <arquivo> [mais arquivos, so com --tarefas]\n", prog);
+    printf("  --dump-ir        mostra a IR (SSA) antes e depois das otimizacoes\n");
+    printf("  --tempo-passes   mostra quanto cada passe de otimizacao custou e removeu\n");
+    printf("  -O0              nao otimiza a IR\n");
+    printf("  --executa        interpreta o programa e mostra o valor final das variaveis\n");
+    printf("  --emite-c <saida.c>  traduz o programa pra C\n");
+    printf("  --aot <executavel>   traduz pra C e compila com o compilador do sistema ($CC)\n");
+    printf("  --bench <n>      compara interpretador e AOT (menor tempo de n execucoes)\n");
+    printf("  --perfil         executa contando operacoes por linha e iteracoes por while (relatorio no stderr)\n");
+    printf("  --perfil-amostra executa so amostrando o tempo por linha (quase sem custo)\n");
+    printf("  --perfil-pilhas <arquivo>  grava as pilhas do perfil no formato collapsed (flamegraph)\n");
+    printf("  --tarefas <n>    roda n tarefas ao mesmo tempo no escalonador, alternando os arquivos\n");
+    printf("  --workers <n>    threads do escalonador (padrao: numero de processadores)\n");
+    printf("  --fatia <n>      passos de cada tarefa antes de ceder a vez (0 = sem preempcao, padrao 10000)\n");
+    printf("  --limite-passos <n>  encerra a tarefa que passar de n passos\n");
+    printf("  --limite-mem <n>     recusa a tarefa cujo quadro passe de n bytes\n");
+    printf("  --bench-expr <n> gera n expressoes e compara avaliar pela arvore e pela forma pos-fixa\n");
+    printf("  --lote <n>       roda n instancias de uma vez (SIMD) e compara com uma por vez\n");
+    printf("  --varia <nome=inicio:passo>  estado inicial da variavel em cada instancia do lote\n");
+}
+
+int main(int argc, char **argv) {
+
+    const char *arquivo = NULL;
+    const char **arquivos = calloc(argc, sizeof(char *));
+    int narquivos = 0, tarefas = 0, bench_expr = 0;
+    ConfigEscalonador esc = { 0, 10000, 0, 0 };
+    const char *emite_c = NULL, *aot = NULL, *pilhas = NULL;
+    int perfil = 0;
+    ModoPerfil modo_perfil = PERFIL_EXATO;
+    int dump_ir = 0, tempo_passes = 0, otimizar = 1, executa = 0, bench = 0, lote = 0;
+    const char **varia = calloc(argc, sizeof(char *));
+    int nvaria = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--dump-ir") == 0) dump_ir = 1;
+        else if (strcmp(argv[i], "--tempo-passes") == 0) tempo_passes = 1;
+        else if (strcmp(argv[i], "-O0") == 0) otimizar = 0;
+        else if (strcmp(argv[i], "--executa") == 0) executa = 1;
+        else if (strcmp(argv[i], "--emite-c") == 0 && i + 1 < argc) emite_c = argv[++i];
+        else if (strcmp(argv[i], "--aot") == 0 && i + 1 < argc) aot = argv[++i];
+        else if (strcmp(argv[i], "--bench") == 0 && i + 1 < argc) bench = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--perfil") == 0) { perfil = 1; modo_perfil = PERFIL_EXATO; }
+        else if (strcmp(argv[i], "--perfil-amostra") == 0) { perfil = 1; modo_perfil = PERFIL_AMOSTRA; }
+        else if (strcmp(argv[i], "--perfil-pilhas") == 0 && i + 1 < argc) pilhas = argv[++i];
+        else if (strcmp(argv[i], "--tarefas") == 0 && i + 1 < argc) tarefas = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc) esc.workers = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--fatia") == 0 && i + 1 < argc) esc.fatia = atoll(argv[++i]);
+        else if (strcmp(argv[i], "--limite-passos") == 0 && i + 1 < argc) esc.limite_passos = atoll(argv[++i]);
+        else if (strcmp(argv[i], "--limite-mem") == 0 && i + 1 < argc) esc.limite_mem = (size_t)atoll(argv[++i]);
+        else if (strcmp(argv[i], "--bench-expr") == 0 && i + 1 < argc) bench_expr = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--lote") == 0 && i + 1 < argc) lote = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--varia") == 0 && i + 1 < argc) varia[nvaria++] = argv[++i];
+        else if (argv[i][0] == '-') { uso(argv[0]); return 1; }
+        else arquivos[narquivos++] = argv[i];
+    }
+    if (narquivos > 0) arquivo = arquivos[0];
+    if (narquivos > 1 && tarefas <= 0) {
+        fprintf(stderr, "Erro: mais de um arquivo so vale com --tarefas (recebi %d)\n", narquivos);
+        uso(argv[0]);
+        free(varia);
+        free(arquivos);
+        return 1;
+    }
+
+    /* Esse não lê arquivo: as expressões são geradas */
+    if (bench_expr > 0) {
+        mostrar_derivacoes = 0;
+        int st = bench_expressoes(bench_expr);
+        free(varia);
+        free(arquivos);
+        return st;
+    }
+
+    if (!arquivo) {
+        uso(argv[0]);
+        return 1;
+    }
+
+    char *src = read_file(arquivo);
+
+    /* Nos outros modos a saída é a IR / o resultado, sem as derivações */
+    if (pilhas) perfil = 1;
+    int usa_ir = dump_ir || tempo_passes || executa || perfil;
+    if (usa_ir || emite_c || aot || bench || lote || tarefas) mostrar_derivacoes = 0;
+
+    /* Passa o scanner e depois o parser */
+    TokenVec tv = tokenize_to_vector(src);
+    Programa *prog = lote > 0 ? parse_program_rpn(&tv) : parse_program(&tv);   /* o lote avalia a pós-fixa */
+
+    int status = 0;
+
+    if (usa_ir) {
+        IRFuncao *ir = ir_gera(prog);
+        if (dump_ir) {
+            printf("; ---- IR gerada ----\n");
+            ir_dump(ir, stdout);
+        }
+        if (otimizar) {
+            EstatPasso estat[16];
+            int n = otimiza(ir, estat, 16);
+            if (dump_ir) {
+                printf("; ---- IR otimizada ----\n");
+                ir_dump(ir, stdout);
+            }
+            if (tempo_passes) imprime_estat(estat, n, stderr);
+        }
+        if (perfil) {
+            Valor *vars = calloc(prog->nvars ? prog->nvars : 1, sizeof(Valor));
+            status = perfil_executa(ir, modo_perfil, src, vars, stderr, pilhas);
+            imprime_variaveis(prog, vars, stdout);
+            free(vars);
+        } else if (executa) {
+            CodigoIR *c = interp_prepara(ir);
+            Valor *vars = calloc(prog->nvars ? prog->nvars : 1, sizeof(Valor));
+            interp_executa(c, vars);
+            imprime_variaveis(prog, vars, stdout);
+            free(vars);
+            interp_free(c);
+        }
+        ir_free(ir);
+    }
+
+    if (emite_c) {
+        FILE *out = fopen(emite_c, "w");
+        if (!out) {
+            fprintf(stderr, "Erro: não consegui criar '%s'\n", emite_c);
+            exit(1);
+        }
+        gera_c(prog, arquivo, out);
+        fclose(out);
+    }
+
+    if (aot) {
+        char arq_c[512];
+        snprintf(arq_c, sizeof arq_c, "%s.c", aot);
+        status = compila_c(prog, arquivo, arq_c, aot);
+    }
+
+    if (bench > 0) status = bench_execucao(prog, arquivo, bench);
+    if (lote > 0) status = bench_lote(prog, lote, varia, nvaria);
+
+    if (tarefas > 0) {
+        /* Os outros arquivos da linha de comando entram na mistura */
+        const Programa **progs = calloc(narquivos, sizeof(Programa *));
+        char **srcs = calloc(narquivos, sizeof(char *));
+        TokenVec *tvs = calloc(narquivos, sizeof(TokenVec));
+        progs[0] = prog;
+        for (int k = 1; k < narquivos; k++) {
+            srcs[k] = read_file(arquivos[k]);
+            tvs[k] = tokenize_to_vector(srcs[k]);
+            progs[k] = parse_program(&tvs[k]);
+        }
+        if (esc.workers <= 0) esc.workers = escalonador_cpus();
+        status = bench_escalona(progs, arquivos, narquivos, tarefas, &esc);
+        for (int k = 1; k < narquivos; k++) {
+            programa_free((Programa *)progs[k]);
+            tv_free(&tvs[k]);
+            free(srcs[k]);
+        }
+        free(progs);
+        free(srcs);
+        free(tvs);
+    }
+    
+    /* Faxina na saída */
+    programa_free(prog);
+    tv_free(&tv);
+    free(src);
+    free(varia);
+    free(arquivos);
+    
+    return status;
 }
\ No newline at end of file
@@ -0,0 +1,409 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "otimizador.h"
+#include "tempo.h"
+
+/* Passes de otimização sobre a IR em SSA.
+   Nenhum passe mexe na forma do grafo (blocos e arestas ficam iguais);
+   eles só removem ou movem instruções dentro dos blocos.
+*/
+
+static void *aloca(size_t n) {
+    void *m = calloc(1, n ? n : 1);
+    if (!m) { perror("calloc"); exit(1); }
+    return m;
+}
+
+/* Tira da lista do bloco as instruções marcadas com bloco == -1 */
+static void compacta_bloco(IRFuncao *f, int bi) {
+    IRBloco *b = &f->blocos[bi];
+    int n = 0;
+    for (int k = 0; k < b->ninstrs; k++) {
+        if (f->vals[b->instrs[k]].bloco == bi) b->instrs[n++] = b->instrs[k];
+    }
+    b->ninstrs = n;
+}
+
+/* === DSE: eliminação de atribuições mortas ===
+   Em SSA uma atribuição é só um valor; se ninguém usa o valor (nem uma
+   condição de desvio, nem o valor final de alguma variável) e ele não pode
+   falhar, ele é morto.
+   Marca a partir das raízes e varre o que sobrou sem marca.
+*/
+int passo_dse(IRFuncao *f) {
+    char *vivo = aloca(f->nvals);
+    int *pilha = aloca(f->nvals * sizeof(int));
+    int topo = 0;
+
+#define RAIZ(x) do { int r_ = (x); if (r_ >= 0 && !vivo[r_]) { vivo[r_] = 1; pilha[topo++] = r_; } } while (0)
+    for (int b = 0; b < f->nblocos; b++) {
+        if (f->blocos[b].term == TERM_BR) RAIZ(f->blocos[b].cond);
+    }
+    for (int v = 0; v < f->prog->nvars; v++) RAIZ(f->saida[v]);
+    for (int b = 0; b < f->nblocos; b++) {
+        /* Divisão inteira que pode falhar fica, mesmo sem uso: o erro é efeito visível */
+        for (int k = 0; k < f->blocos[b].ninstrs; k++) {
+            if (ir_pode_falhar(f, f->blocos[b].instrs[k])) RAIZ(f->blocos[b].instrs[k]);
+        }
+    }
+
+    while (topo > 0) {
+        const IRValor *v = &f->vals[pilha[--topo]];
+        RAIZ(v->a);
+        RAIZ(v->b);
+    }
+#undef RAIZ
+
+    int removidas = 0;
+    for (int b = 0; b < f->nblocos; b++) {
+        IRBloco *bl = &f->blocos[b];
+        for (int k = 0; k < bl->ninstrs; k++) {
+            if (!vivo[bl->instrs[k]]) {
+                f->vals[bl->instrs[k]].bloco = -1;
+                removidas++;
+            }
+        }
+        compacta_bloco(f, b);
+    }
+
+    free(vivo);
+    free(pilha);
+    return removidas;
+}
+
+/* === GVN: numeração global de valores ===
+   Percorre a árvore de dominadores com uma tabela hash de expressões
+   disponíveis. Se a mesma operação com os mesmos operandos já foi calculada
+   num bloco dominador, reaproveita. De quebra dobra constantes, aplica
+   identidades simples (x + 0, x * 1) e some com phis triviais (phi(x, x)).
+*/
+
+typedef struct {
+    IRFuncao *f;
+    int *repl;        /* valor -> valor que o substitui */
+    int *idom;
+    int *filhos, *ifilhos;  /* filhos na árvore de dominadores (CSR) */
+    int *tabela;      /* hash aberto com sondagem linear, -1 = vazio */
+    int  mascara;
+    int *inseridos;   /* pilha de posições usadas, pra desfazer ao sair do escopo */
+    int  ninseridos;
+    int  alteracoes;
+} GVN;
+
+static int resolve(const GVN *g, int v) {
+    while (v >= 0 && g->repl[v] != v) v = g->repl[v];
+    return v;
+}
+
+static unsigned hash_valor(const IRValor *v) {
+    unsigned h = (unsigned)v->op * 2654435761u + (unsigned)v->tipo;
+    if (v->op == IR_CONST || v->op == IR_PARAM) {
+        unsigned long long bits;
+        memcpy(&bits, &v->cte, sizeof bits);
+        h ^= (unsigned)(bits ^ (bits >> 32));
+    } else {
+        h ^= (unsigned)v->a * 40503u;
+        h ^= (unsigned)v->b * 2246822519u;
+    }
+    return h * 2654435761u;
+}
+
+static int mesmo_valor(const IRValor *x, const IRValor *y) {
+    if (x->op != y->op || x->tipo != y->tipo) return 0;
+    if (x->op == IR_CONST || x->op == IR_PARAM) return memcmp(&x->cte, &y->cte, sizeof x->cte) == 0;
+    return x->a == y->a && x->b == y->b;
+}
+
+static int comutativa(IROp op) {
+    return op == IR_ADD || op == IR_MUL || op == IR_EQ || op == IR_NE;
+}
+
+static void calcula_dominadores(GVN *g) {
+    IRFuncao *f = g->f;
+    int n = f->nblocos;
+    int *idom = g->idom;
+    for (int b = 0; b < n; b++) idom[b] = -1;
+    idom[0] = 0;
+
+    /* Cooper-Harvey-Kennedy. A ordem de criação dos blocos já é topológica
+       (ignorando as arestas de volta dos while), então serve de RPO. */
+    int mudou = 1;
+    while (mudou) {
+        mudou = 0;
+        for (int b = 1; b < n; b++) {
+            const IRBloco *bl = &f->blocos[b];
+            int novo = -1;
+            for (int k = 0; k < bl->npred; k++) {
+                int p = bl->pred[k];
+                if (idom[p] < 0) continue;
+                if (novo < 0) { novo = p; continue; }
+                int x = p, y = novo;
+                while (x != y) {
+                    while (x > y) x = idom[x];
+                    while (y > x) y = idom[y];
+                }
+                novo = x;
+            }
+            if (novo >= 0 && idom[b] != novo) { idom[b] = novo; mudou = 1; }
+        }
+    }
+
+    /* Monta a lista de filhos em formato compacto */
+    int *cont = aloca((n + 1) * sizeof(int));
+    for (int b = 1; b < n; b++) if (idom[b] >= 0) cont[idom[b] + 1]++;
+    for (int b = 0; b < n; b++) cont[b + 1] += cont[b];
+    g->ifilhos = cont;
+    g->filhos = aloca(n * sizeof(int));
+    int *pos = aloca(n * sizeof(int));
+    for (int b = 1; b < n; b++) {
+        if (idom[b] >= 0) g->filhos[cont[idom[b]] + pos[idom[b]]++] = b;
+    }
+    free(pos);
+}
+
+static int busca_ou_insere(GVN *g, int id) {
+    const IRValor *v = &g->f->vals[id];
+    unsigned i = hash_valor(v) & g->mascara;
+    while (g->tabela[i] >= 0) {
+        if (mesmo_valor(&g->f->vals[g->tabela[i]], v)) return g->tabela[i];
+        i = (i + 1) & g->mascara;
+    }
+    g->tabela[i] = id;
+    g->inseridos[g->ninseridos++] = (int)i;
+    return id;
+}
+
+static int eh_const(const IRFuncao *f, int v, int num) {
+    if (v < 0 || f->vals[v].op != IR_CONST) return 0;
+    const IRValor *c = &f->vals[v];
+    return c->tipo == TIPO_INTEGER ? c->cte.i == num : c->cte.f == (double)num;
+}
+
+/* Zero real com o sinal pedido (0.0 == -0.0 no ==, então olha o bit) */
+static int eh_zero_real(const IRFuncao *f, int v, int negativo) {
+    if (v < 0 || f->vals[v].op != IR_CONST || f->vals[v].tipo != TIPO_REAL) return 0;
+    double c = f->vals[v].cte.f;
+    return c == 0.0 && (signbit(c) != 0) == negativo;
+}
+
+/* Se a operação não muda o operando, devolve ele; senão -1.
+   Em real o zero tem sinal: 0.0 + (-0.0) dá +0.0, então x + 0.0 não é x.
+   Só x + (-0.0) e x - 0.0 devolvem x pra todo x. */
+static int identidade(const IRFuncao *f, const IRValor *v) {
+    int real = v->tipo == TIPO_REAL;
+    switch (v->op) {
+        case IR_ADD:
+            if (real) {
+                if (eh_zero_real(f, v->b, 1)) return v->a;
+                if (eh_zero_real(f, v->a, 1)) return v->b;
+                break;
+            }
+            if (eh_const(f, v->b, 0)) return v->a;
+            if (eh_const(f, v->a, 0)) return v->b;
+            break;
+        case IR_SUB:
+            if (real ? eh_zero_real(f, v->b, 0) : eh_const(f, v->b, 0)) return v->a;
+            break;
+        case IR_MUL:
+            if (eh_const(f, v->b, 1)) return v->a;
+            if (eh_const(f, v->a, 1)) return v->b;
+            break;
+        case IR_DIV:
+            if (eh_const(f, v->b, 1)) return v->a;
+            break;
+        default:
+            break;
+    }
+    return -1;
+}
+
+static void gvn_bloco(GVN *g, int bi) {
+    IRFuncao *f = g->f;
+    IRBloco *b = &f->blocos[bi];
+    int marca = g->ninseridos;
+
+    for (int k = 0; k < b->ninstrs; k++) {
+        int id = b->instrs[k];
+        IRValor *v = &f->vals[id];
+        v->a = resolve(g, v->a);
+        v->b = resolve(g, v->b);
+
+        if (v->op == IR_PHI) {
+            /* phi(x, x) ou phi(x, ela mesma) é só x */
+            if (v->a == v->b || v->b == id) {
+                g->repl[id] = v->a;
+                v->bloco = -1;
+                g->alteracoes++;
+            }
+            continue;
+        }
+
+        /* Dobra constantes: 2 * 3 vira const 6 (divisão inteira por zero fica pra execução) */
+        if (v->a >= 0 && f->vals[v->a].op == IR_CONST &&
+            (v->b < 0 || f->vals[v->b].op == IR_CONST)) {
+            Valor x = f->vals[v->a].cte, y = { 0 }, r;
+            if (v->b >= 0) y = f->vals[v->b].cte;
+            if (ir_dobra(v->op, f->vals[v->a].tipo, x, y, &r)) {
+                v->cte = r;
+                v->op = IR_CONST;
+                v->a = v->b = -1;
+            }
+        }
+
+        /* Identidades: x + 0, x - 0, x * 1, x / 1 são só x */
+        int x = identidade(f, v);
+        if (x >= 0) {
+            g->repl[id] = x;
+            v->bloco = -1;
+            g->alteracoes++;
+            continue;
+        }
+
+        if (comutativa(v->op) && v->a > v->b) {
+            int t = v->a; v->a = v->b; v->b = t;
+        }
+
+        int igual = busca_ou_insere(g, id);
+        if (igual != id) {
+            g->repl[id] = igual;
+            v->bloco = -1;
+            g->alteracoes++;
+        }
+    }
+    compacta_bloco(f, bi);
+
+    for (int k = g->ifilhos[bi]; k < g->ifilhos[bi + 1]; k++) gvn_bloco(g, g->filhos[k]);
+
+    /* Sai do escopo: o que foi inserido aqui não vale nos irmãos */
+    while (g->ninseridos > marca) g->tabela[g->inseridos[--g->ninseridos]] = -1;
+}
+
+int passo_gvn(IRFuncao *f) {
+    GVN g;
+    memset(&g, 0, sizeof g);
+    g.f = f;
+    g.repl = aloca(f->nvals * sizeof(int));
+    for (int v = 0; v < f->nvals; v++) g.repl[v] = v;
+    g.idom = aloca(f->nblocos * sizeof(int));
+    calcula_dominadores(&g);
+
+    int cap = 16;
+    while (cap < 2 * f->nvals) cap *= 2;
+    g.mascara = cap - 1;
+    g.tabela = aloca(cap * sizeof(int));
+    memset(g.tabela, -1, cap * sizeof(int));
+    g.inseridos = aloca(f->nvals * sizeof(int));
+
+    gvn_bloco(&g, 0);
+
+    /* Operandos que apontam pra valores substituídos depois de usados
+       (ex: o valor que volta do fim do while pra phi da cabeça) */
+    for (int b = 0; b < f->nblocos; b++) {
+        IRBloco *bl = &f->blocos[b];
+        for (int k = 0; k < bl->ninstrs; k++) {
+            IRValor *v = &f->vals[bl->instrs[k]];
+            v->a = resolve(&g, v->a);
+            v->b = resolve(&g, v->b);
+        }
+        if (bl->term == TERM_BR) bl->cond = resolve(&g, bl->cond);
+    }
+    for (int v = 0; v < f->prog->nvars; v++) f->saida[v] = resolve(&g, f->saida[v]);
+
+    free(g.repl);
+    free(g.idom);
+    free(g.filhos);
+    free(g.ifilhos);
+    free(g.tabela);
+    free(g.inseridos);
+    return g.alteracoes;
+}
+
+/* === LICM: tira do while o que não muda entre iterações ===
+   Uma instrução é invariante se todos os operandos vêm de fora do laço
+   (ou de outra instrução que já foi movida). Ela vai pro fim do preheader,
+   o bloco que entra no laço. Os laços internos vêm primeiro na lista, então
+   o que sai de um laço interno ainda pode subir mais um nível no externo.
+
+   Divisão inteira que pode falhar não sobe: se o laço não rodar nenhuma
+   vez, ela não podia executar.
+*/
+
+static void anexa_instr(IRBloco *b, int id) {
+    if (b->ninstrs == b->capinstrs) {
+        b->capinstrs = b->capinstrs ? b->capinstrs * 2 : 16;
+        b->instrs = realloc(b->instrs, b->capinstrs * sizeof(int));
+        if (!b->instrs) { perror("realloc"); exit(1); }
+    }
+    b->instrs[b->ninstrs++] = id;
+}
+
+static int fora_do_laco(const IRFuncao *f, const IRLaco *l, int v) {
+    if (v < 0) return 1;
+    int b = f->vals[v].bloco;
+    return b < l->primeiro || b > l->ultimo;
+}
+
+int passo_licm(IRFuncao *f) {
+    int movidas = 0;
+    for (int li = 0; li < f->nlacos; li++) {
+        const IRLaco *l = &f->lacos[li];
+        for (int bi = l->primeiro; bi <= l->ultimo; bi++) {
+            IRBloco *b = &f->blocos[bi];
+            for (int k = 0; k < b->ninstrs; k++) {
+                int id = b->instrs[k];
+                IRValor *v = &f->vals[id];
+                if (v->op == IR_PHI || ir_pode_falhar(f, id)) continue;
+                if (!fora_do_laco(f, l, v->a) || !fora_do_laco(f, l, v->b)) continue;
+
+                anexa_instr(&f->blocos[l->preheader], id);
+                v->bloco = l->preheader;
+                movidas++;
+            }
+            compacta_bloco(f, bi);
+        }
+    }
+    return movidas;
+}
+
+/* === Pipeline === */
+
+typedef int (*Passo)(IRFuncao *f);
+
+static const struct { const char *nome; Passo fn; } pipeline[] = {
+    { "dse",  passo_dse  },   /* limpa o que o programa nunca lê */
+    { "gvn",  passo_gvn  },
+    { "licm", passo_licm },
+    { "gvn",  passo_gvn  },   /* junta as cópias que o licm subiu pro mesmo preheader */
+    { "dse",  passo_dse  },   /* recolhe o que ficou sem uso */
+};
+
+int otimiza(IRFuncao *f, EstatPasso *estat, int max) {
+    int n = (int)(sizeof pipeline / sizeof pipeline[0]);
+    for (int i = 0; i < n; i++) {
+        int antes = ir_conta_instrs(f);
+        double t0 = agora_ns();
+        int alt = pipeline[i].fn(f);
+        double t1 = agora_ns();
+        if (estat && i < max) {
+            estat[i].nome = pipeline[i].nome;
+            estat[i].ns = t1 - t0;
+            estat[i].antes = antes;
+            estat[i].depois = ir_conta_instrs(f);
+            estat[i].alteracoes = alt;
+        }
+    }
+    return n < max ? n : max;
+}
+
+void imprime_estat(const EstatPasso *estat, int n, FILE *out) {
+    fprintf(out, "%-6s %12s %8s %8s %10s\n", "passe", "tempo(us)", "antes", "depois", "alteradas");
+    double total = 0.0;
+    for (int i = 0; i < n; i++) {
+        fprintf(out, "%-6s %12.2f %8d %8d %10d\n", estat[i].nome, estat[i].ns / 1000.0,
+                estat[i].antes, estat[i].depois, estat[i].alteracoes);
+        total += estat[i].ns;
+    }
+    fprintf(out, "%-6s %12.2f\n", "total", total / 1000.0);
+}
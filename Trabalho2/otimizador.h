@@ -0,0 +1,25 @@
+#ifndef OTIMIZADOR_H
+#define OTIMIZADOR_H
+
+#include <stdio.h>
+#include "ir.h"
+
+/* Estatística de um passe: quanto custou e quanto mexeu na IR */
+typedef struct {
+    const char *nome;
+    double ns;
+    int antes, depois;   /* instruções na IR antes/depois do passe */
+    int alteracoes;      /* removidas (dse/gvn) ou movidas (licm) */
+} EstatPasso;
+
+/* Passes individuais; cada um devolve quantas instruções alterou */
+int passo_dse(IRFuncao *f);
+int passo_gvn(IRFuncao *f);
+int passo_licm(IRFuncao *f);
+
+/* Roda o pipeline inteiro. Se estat != NULL, preenche até max entradas
+   e devolve quantos passes rodaram. */
+int  otimiza(IRFuncao *f, EstatPasso *estat, int max);
+void imprime_estat(const EstatPasso *estat, int n, FILE *out);
+
+#endif
@@ -0,0 +1,293 @@
+#ifndef _WIN32
+#define _XOPEN_SOURCE 600   /* sigaction / setitimer */
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#ifndef _WIN32
+#include <sys/time.h>
+#endif
+#include "perfil.h"
+#include "interpretador.h"
+#include "tempo.h"
+
+#define INTERVALO_US 1000   /* uma amostra por milissegundo de CPU */
+#define MAX_LINHAS_REL 20   /* linhas mostradas no relatório */
+
+static void *aloca(size_t n) {
+    void *m = calloc(1, n ? n : 1);
+    if (!m) { perror("calloc"); exit(1); }
+    return m;
+}
+
+/* -------------------- Relógio de amostragem -------------------- */
+
+#ifndef _WIN32
+static void tique(int sig) {
+    (void)sig;
+    interp_amostrar = 1;
+}
+
+static int relogio_liga(void) {
+    struct sigaction sa;
+    memset(&sa, 0, sizeof sa);
+    sa.sa_handler = tique;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = SA_RESTART;
+    if (sigaction(SIGPROF, &sa, NULL) != 0) return 0;
+
+    struct itimerval t;
+    t.it_interval.tv_sec = 0;
+    t.it_interval.tv_usec = INTERVALO_US;
+    t.it_value = t.it_interval;
+    return setitimer(ITIMER_PROF, &t, NULL) == 0;
+}
+
+static void relogio_desliga(void) {
+    struct itimerval t;
+    memset(&t, 0, sizeof t);
+    setitimer(ITIMER_PROF, &t, NULL);
+    signal(SIGPROF, SIG_IGN);
+}
+#else
+/* Sem SIGPROF no Windows: só o modo exato tem números */
+static int relogio_liga(void) { return 0; }
+static void relogio_desliga(void) {}
+#endif
+
+/* -------------------- Atribuição por linha -------------------- */
+
+typedef struct {
+    int       linha;
+    int       usada;      /* tem alguma operação da IR nessa linha */
+    long long instrs;     /* operações executadas (modo exato) */
+    double    amostras;   /* amostras do bloco divididas pelas operações dele */
+} LinhaPerfil;
+
+typedef struct {
+    const IRLaco *laco;
+    long long entradas, iteracoes, instrs;
+    double    amostras;
+} LacoPerfil;
+
+static int cmp_linha(const void *a, const void *b) {
+    const LinhaPerfil *x = a, *y = b;
+    if (x->amostras != y->amostras) return x->amostras < y->amostras ? 1 : -1;
+    if (x->instrs != y->instrs) return x->instrs < y->instrs ? 1 : -1;
+    return x->linha - y->linha;
+}
+
+static int cmp_laco(const void *a, const void *b) {
+    const LacoPerfil *x = a, *y = b;
+    if (x->amostras != y->amostras) return x->amostras < y->amostras ? 1 : -1;
+    if (x->instrs != y->instrs) return x->instrs < y->instrs ? 1 : -1;
+    return x->laco->pos - y->laco->pos;
+}
+
+/* Operações contadas de cada bloco (pra repartir as amostras) */
+static int *ops_por_bloco(const CodigoIR *c) {
+    int *n = aloca(c->nblocos * sizeof(int));
+    for (int pc = 0; pc < c->ncode; pc++)
+        if (interp_conta_instr(c, pc)) n[c->bloco_de[pc]]++;
+    return n;
+}
+
+/* Copia o texto da linha (sem espaços na frente) pra buf */
+static void texto_linha(const char *src, int linha, char *buf, size_t n) {
+    buf[0] = '\0';
+    if (!src || linha < 1) return;
+    const char *p = src;
+    for (int l = 1; l < linha && *p; p++)
+        if (*p == '\n') l++;
+    while (*p == ' ' || *p == '\t') p++;
+    size_t k = 0;
+    while (p[k] && p[k] != '\n' && p[k] != '\r' && k + 1 < n) { buf[k] = p[k]; k++; }
+    buf[k] = '\0';
+}
+
+/* -------------------- Pilhas (formato collapsed) -------------------- */
+
+static char *copia(const char *s) {
+    char *d = aloca(strlen(s) + 1);
+    strcpy(d, s);
+    return d;
+}
+
+static void marca(char **pilha, int maxlinha, int linha, const char *buf) {
+    if (linha >= 0 && linha <= maxlinha && !pilha[linha]) pilha[linha] = copia(buf);
+}
+
+/* Cada linha ganha a pilha de whiles que a envolvem; a linha do próprio
+   while fica dentro dele (é a condição que roda a cada iteração) */
+static void pilhas_cmd(Fonte *f, const Comando *c, char *buf, size_t cap, char **pilha, int maxlinha) {
+    for (; c; c = c->prox) {
+        int linha = fonte_linha(f, c->pos);
+        switch (c->kind) {
+            case CMD_ATRIB:
+                marca(pilha, maxlinha, linha, buf);
+                break;
+            case CMD_COMPOSTO:
+                pilhas_cmd(f, c->corpo, buf, cap, pilha, maxlinha);
+                break;
+            case CMD_IF:
+                marca(pilha, maxlinha, linha, buf);
+                pilhas_cmd(f, c->corpo, buf, cap, pilha, maxlinha);
+                pilhas_cmd(f, c->senao, buf, cap, pilha, maxlinha);
+                break;
+            case CMD_WHILE: {
+                size_t n = strlen(buf);
+                snprintf(buf + n, cap - n, ";while@%d", linha);
+                marca(pilha, maxlinha, linha, buf);
+                pilhas_cmd(f, c->corpo, buf, cap, pilha, maxlinha);
+                buf[n] = '\0';
+                break;
+            }
+        }
+    }
+}
+
+/* Peso de cada linha: operações no modo exato, microssegundos estimados
+   na amostragem */
+static int escreve_pilhas(const char *arquivo, const Programa *prog, const LinhaPerfil *lin,
+                          int maxlinha, ModoPerfil modo, double ns_por_amostra) {
+    FILE *out = fopen(arquivo, "w");
+    if (!out) {
+        fprintf(stderr, "Erro: não consegui criar '%s'\n", arquivo);
+        return 1;
+    }
+    char **pilha = aloca((maxlinha + 1) * sizeof(char *));
+    char buf[4096];
+    snprintf(buf, sizeof buf, "%s", prog->nome ? prog->nome : "programa");
+    pilhas_cmd(prog->fonte, prog->corpo, buf, sizeof buf, pilha, maxlinha);
+
+    for (int l = 0; l <= maxlinha; l++) {
+        long long peso = (modo == PERFIL_EXATO) ? lin[l].instrs
+                       : (long long)(lin[l].amostras * ns_por_amostra / 1e3 + 0.5);
+        if (peso <= 0) continue;
+        const char *base = pilha[l] ? pilha[l] : buf;
+        if (l == 0) fprintf(out, "%s;(sem linha) %lld\n", base, peso);
+        else        fprintf(out, "%s;linha %d %lld\n", base, l, peso);
+    }
+    for (int l = 0; l <= maxlinha; l++) free(pilha[l]);
+    free(pilha);
+    fclose(out);
+    return 0;
+}
+
+/* -------------------- Execução e relatório -------------------- */
+
+int perfil_executa(const IRFuncao *ir, ModoPerfil modo, const char *src,
+                   Valor *vars, FILE *rel, const char *pilhas) {
+    CodigoIR *c = (modo == PERFIL_EXATO) ? interp_prepara_perfil(ir) : interp_prepara(ir);
+
+    interp_amostrar = 0;
+    int com_relogio = relogio_liga();
+    if (!com_relogio) fprintf(rel, "perfil: sem relogio de amostragem, tempos por linha indisponiveis\n");
+    double t0 = agora_ns();
+    interp_executa_amostrando(c, vars);
+    double total_ns = agora_ns() - t0;
+    if (com_relogio) relogio_desliga();
+
+    /* Repassa contadores e amostras de cada bloco pras linhas */
+    int maxlinha = 0;
+    int *linha_de = aloca(c->ncode * sizeof(int));
+    for (int pc = 0; pc < c->ncode; pc++) {
+        linha_de[pc] = fonte_linha(ir->prog->fonte, c->code[pc].pos);
+        if (linha_de[pc] > maxlinha) maxlinha = linha_de[pc];
+    }
+    LinhaPerfil *lin = aloca((maxlinha + 1) * sizeof(LinhaPerfil));
+    for (int l = 0; l <= maxlinha; l++) lin[l].linha = l;
+
+    int *nops = ops_por_bloco(c);
+    long long total_instrs = 0, total_amostras = 0;
+    for (int bi = 0; bi < c->nblocos; bi++) {
+        total_amostras += c->amostras[bi];
+        if (nops[bi] == 0) lin[0].amostras += (double)c->amostras[bi];
+    }
+    for (int pc = 0; pc < c->ncode; pc++) {
+        if (!interp_conta_instr(c, pc)) continue;
+        int bi = c->bloco_de[pc];
+        LinhaPerfil *L = &lin[linha_de[pc]];
+        L->usada = 1;
+        L->instrs += c->conta[bi];
+        L->amostras += (double)c->amostras[bi] / nops[bi];
+        total_instrs += c->conta[bi];
+    }
+    double ns_por_amostra = total_amostras ? total_ns / (double)total_amostras : 0.0;
+
+    /* Laços: a cabeça roda uma vez por iteração e mais uma na saída, e o
+       preheader uma vez por entrada */
+    LacoPerfil *lac = aloca(ir->nlacos * sizeof(LacoPerfil));
+    for (int k = 0; k < ir->nlacos; k++) {
+        const IRLaco *l = &ir->lacos[k];
+        lac[k].laco = l;
+        lac[k].entradas = c->conta[l->preheader];
+        lac[k].iteracoes = c->conta[l->cabeca] - lac[k].entradas;
+        for (int bi = l->primeiro; bi <= l->ultimo; bi++) {
+            lac[k].instrs += c->conta[bi] * nops[bi];
+            lac[k].amostras += (double)c->amostras[bi];
+        }
+    }
+
+    fprintf(rel, "perfil (%s): %.3f ms, %lld amostras",
+            modo == PERFIL_EXATO ? "exato" : "amostragem", total_ns / 1e6, total_amostras);
+    if (modo == PERFIL_EXATO) fprintf(rel, ", %lld operacoes", total_instrs);
+    fprintf(rel, "\n");
+
+    /* Linhas mais quentes */
+    LinhaPerfil *ord = aloca((maxlinha + 1) * sizeof(LinhaPerfil));
+    int nord = 0;
+    for (int l = 0; l <= maxlinha; l++)
+        if (lin[l].usada || lin[l].amostras > 0) ord[nord++] = lin[l];
+    qsort(ord, nord, sizeof(LinhaPerfil), cmp_linha);
+
+    fprintf(rel, "%6s %14s %7s %12s %7s  %s\n", "linha", "operacoes", "%", "tempo(ms)", "%", "comando");
+    for (int k = 0; k < nord && k < MAX_LINHAS_REL; k++) {
+        const LinhaPerfil *L = &ord[k];
+        char txt[48];
+        texto_linha(src, L->linha, txt, sizeof txt);
+        if (L->linha == 0) fprintf(rel, "%6s", "-");
+        else               fprintf(rel, "%6d", L->linha);
+        if (modo == PERFIL_EXATO)
+            fprintf(rel, " %14lld %6.1f%%", L->instrs, total_instrs ? 100.0 * L->instrs / total_instrs : 0.0);
+        else
+            fprintf(rel, " %14s %7s", "-", "-");
+        if (total_amostras)
+            fprintf(rel, " %12.3f %6.1f%%", L->amostras * ns_por_amostra / 1e6, 100.0 * L->amostras / total_amostras);
+        else
+            fprintf(rel, " %12s %7s", "-", "-");
+        fprintf(rel, "  %s\n", L->linha ? txt : "(sem linha)");
+    }
+    if (nord > MAX_LINHAS_REL) fprintf(rel, "  ... mais %d linhas\n", nord - MAX_LINHAS_REL);
+
+    /* Laços mais quentes (o tempo de um laço inclui os internos) */
+    if (ir->nlacos > 0) {
+        qsort(lac, ir->nlacos, sizeof(LacoPerfil), cmp_laco);
+        fprintf(rel, "%6s %10s %14s %12s %12s %7s\n", "while", "entradas", "iteracoes", "iter/entrada", "tempo(ms)", "%");
+        for (int k = 0; k < ir->nlacos; k++) {
+            const LacoPerfil *L = &lac[k];
+            fprintf(rel, "%6d", fonte_linha(ir->prog->fonte, L->laco->pos));
+            if (modo == PERFIL_EXATO)
+                fprintf(rel, " %10lld %14lld %12.1f", L->entradas, L->iteracoes,
+                        L->entradas ? (double)L->iteracoes / L->entradas : 0.0);
+            else
+                fprintf(rel, " %10s %14s %12s", "-", "-", "-");
+            if (total_amostras)
+                fprintf(rel, " %12.3f %6.1f%%\n", L->amostras * ns_por_amostra / 1e6, 100.0 * L->amostras / total_amostras);
+            else
+                fprintf(rel, " %12s %7s\n", "-", "-");
+        }
+    }
+
+    int status = 0;
+    if (pilhas) status = escreve_pilhas(pilhas, ir->prog, lin, maxlinha, modo, ns_por_amostra);
+
+    free(ord);
+    free(lac);
+    free(nops);
+    free(linha_de);
+    free(lin);
+    interp_free(c);
+    return status;
+}
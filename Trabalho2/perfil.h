@@ -0,0 +1,33 @@
+#ifndef PERFIL_H
+#define PERFIL_H
+
+#include <stdio.h>
+#include "ir.h"
+
+/* -------------------- Perfil de execução --------------------
+   Roda o programa no interpretador da IR e diz onde o tempo foi gasto,
+   por linha do fonte (cada valor da IR carrega o byte de onde veio, e a linha
+   sai do índice de quebras do Fonte).
+
+   Dois modos:
+     - exato: o código ganha um contador no começo de cada bloco. Dá o
+       número exato de operações por linha e de iterações de cada while.
+     - amostragem: sem contador nenhum; um relógio (SIGPROF) liga uma
+       bandeira a cada milissegundo de CPU e o próximo desvio anota o bloco.
+   Nos dois, o tempo por linha vem das amostras. Sem perfil, o interpretador
+   roda a versão sem teste de amostra (custo zero).
+
+   O relatório sai ordenado (linhas e laços mais quentes primeiro). As pilhas
+   no formato "collapsed" (programa;while@8;linha 13 peso) servem direto pro
+   flamegraph.pl / speedscope.
+*/
+
+typedef enum { PERFIL_EXATO, PERFIL_AMOSTRA } ModoPerfil;
+
+/* Executa ir (já otimizada ou não) a partir de vars (entra/sai), escreve o
+   relatório em rel e, se pilhas != NULL, o arquivo de pilhas. 'src' é o
+   fonte, pra mostrar o texto de cada linha. Devolve 0 se deu certo. */
+int perfil_executa(const IRFuncao *ir, ModoPerfil modo, const char *src,
+                   Valor *vars, FILE *rel, const char *pilhas);
+
+#endif
@@ -0,0 +1,167 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "rpn.h"
+#include "tipos.h"
+
+static void *cresce(void *v, uint32_t *cap, size_t tam) {
+    *cap = *cap ? *cap * 2 : 64;
+    v = realloc(v, (size_t)*cap * tam);
+    if (!v) { perror("realloc"); exit(1); }
+    return v;
+}
+
+static void emite(RpnEmissor *em, RpnOp op, Tipo t, int conv, uint32_t arg) {
+    Rpn *r = em->rpn;
+    if (r->nnos == r->capnos) r->nos = cresce(r->nos, &r->capnos, sizeof(RpnNo));
+    RpnNo *n = &r->nos[r->nnos++];
+    n->op = (uint8_t)op;
+    n->tipo = (uint8_t)t;
+    n->conv = (uint8_t)conv;
+    n->livre = 0;
+    n->arg = arg;
+}
+
+/* A pilha de tipos cresce junto com a expressão; 'maior' vira o tamanho
+   da pilha que a avaliação vai precisar */
+static void empilha(RpnEmissor *em, Tipo t) {
+    if (em->prof == em->captipos) {
+        em->captipos = em->captipos ? em->captipos * 2 : RPN_PILHA;
+        em->tipos = realloc(em->tipos, em->captipos * sizeof(Tipo));
+        if (!em->tipos) { perror("realloc"); exit(1); }
+    }
+    em->tipos[em->prof++] = t;
+    if (em->prof > em->maior) em->maior = em->prof;
+}
+
+void rpn_comeca(RpnEmissor *em, Rpn *rpn) {
+    em->rpn = rpn;
+    em->ini = rpn ? rpn->nnos : 0;
+    em->prof = 0;
+    em->maior = 0;
+}
+
+void rpn_emissor_libera(RpnEmissor *em) {
+    free(em->tipos);
+    em->tipos = NULL;
+    em->captipos = 0;
+}
+
+void rpn_num(RpnEmissor *em, Valor num, Tipo t) {
+    if (!em->rpn) return;
+    empilha(em, t);
+    Rpn *r = em->rpn;
+    if (r->nctes == r->capctes) r->ctes = cresce(r->ctes, &r->capctes, sizeof(Valor));
+    r->ctes[r->nctes] = num;
+    emite(em, RPN_NUM, t, 0, r->nctes++);
+}
+
+void rpn_var(RpnEmissor *em, int var, Tipo t) {
+    if (!em->rpn) return;
+    empilha(em, t);
+    emite(em, RPN_VAR, t, 0, (uint32_t)var);
+}
+
+void rpn_op(RpnEmissor *em, RpnOp op, int pos) {
+    if (!em->rpn) return;
+    if (op == RPN_NEG) {
+        emite(em, op, em->tipos[em->prof - 1], 0, 0);
+        return;
+    }
+    Tipo tb = em->tipos[--em->prof];
+    Tipo ta = em->tipos[--em->prof];
+    Tipo t = tipo_comum(ta, tb);
+    int conv = (ta != t ? RPN_CONV_A : 0) | (tb != t ? RPN_CONV_B : 0);
+    empilha(em, op >= RPN_EQ ? TIPO_INTEGER : t);
+    emite(em, op, t, conv, op == RPN_DIV ? (uint32_t)pos : 0);
+}
+
+RpnExpr rpn_termina(RpnEmissor *em) {
+    RpnExpr e;
+    e.ini = em->ini;
+    e.n = em->rpn ? em->rpn->nnos - em->ini : 0;
+    e.pilha = (uint32_t)em->maior;
+    return e;
+}
+
+Tipo rpn_tipo(const Rpn *rpn, RpnExpr e) {
+    const RpnNo *n = &rpn->nos[e.ini + e.n - 1];
+    return n->op >= RPN_EQ ? TIPO_INTEGER : (Tipo)n->tipo;
+}
+
+#define U(x) ((unsigned long long)(x))
+
+/* Um laço só, sem recursão: folha empilha, operação desempilha os operandos
+   e empilha o resultado. A pilha fica no quadro da função; só expressão mais
+   funda que RPN_PILHA pede uma no heap. */
+int rpn_avalia(const Rpn *rpn, RpnExpr e, const Valor *vars, Valor *res) {
+    Valor fixa[RPN_PILHA];
+    Valor *pilha = fixa;
+    if (e.pilha > RPN_PILHA) {
+        pilha = malloc(e.pilha * sizeof(Valor));
+        if (!pilha) { perror("malloc"); exit(1); }
+    }
+    int topo = 0, erro = 0;
+    const RpnNo *n = rpn->nos + e.ini, *fim = n + e.n;
+
+    for (; n < fim; n++) {
+        if (n->op == RPN_NUM) { pilha[topo++] = rpn->ctes[n->arg]; continue; }
+        if (n->op == RPN_VAR) { pilha[topo++] = vars[n->arg]; continue; }
+
+        Valor *a = &pilha[topo - 1];
+        if (n->op == RPN_NEG) {
+            if (n->tipo == TIPO_INTEGER) a->i = (long long)(0 - U(a->i));
+            else                         a->f = -a->f;
+            continue;
+        }
+
+        Valor b = pilha[--topo];
+        a = &pilha[topo - 1];
+        if (n->conv & RPN_CONV_A) a->f = (double)a->i;
+        if (n->conv & RPN_CONV_B) b.f = (double)b.i;
+
+        if (n->tipo == TIPO_INTEGER) {
+            switch (n->op) {
+                case RPN_ADD: a->i = (long long)(U(a->i) + U(b.i)); break;
+                case RPN_SUB: a->i = (long long)(U(a->i) - U(b.i)); break;
+                case RPN_MUL: a->i = (long long)(U(a->i) * U(b.i)); break;
+                case RPN_DIV:
+                    if (b.i == 0) { erro = 1; goto fim; }
+                    a->i = div_inteira(a->i, b.i);
+                    break;
+                case RPN_EQ: a->i = a->i == b.i; break;
+                case RPN_NE: a->i = a->i != b.i; break;
+                case RPN_LT: a->i = a->i <  b.i; break;
+                case RPN_LE: a->i = a->i <= b.i; break;
+                case RPN_GT: a->i = a->i >  b.i; break;
+                case RPN_GE: a->i = a->i >= b.i; break;
+            }
+        } else {
+            switch (n->op) {
+                case RPN_ADD: a->f = a->f + b.f; break;
+                case RPN_SUB: a->f = a->f - b.f; break;
+                case RPN_MUL: a->f = a->f * b.f; break;
+                case RPN_DIV: a->f = a->f / b.f; break;
+                case RPN_EQ: a->i = a->f == b.f; break;
+                case RPN_NE: a->i = a->f != b.f; break;
+                case RPN_LT: a->i = a->f <  b.f; break;
+                case RPN_LE: a->i = a->f <= b.f; break;
+                case RPN_GT: a->i = a->f >  b.f; break;
+                case RPN_GE: a->i = a->f >= b.f; break;
+            }
+        }
+    }
+    *res = pilha[0];
+fim:
+    if (pilha != fixa) free(pilha);
+    return erro;
+}
+
+#undef U
+
+void rpn_free(Rpn *rpn) {
+    free(rpn->nos);
+    free(rpn->ctes);
+    rpn->nos = NULL;
+    rpn->ctes = NULL;
+    rpn->nnos = rpn->capnos = rpn->nctes = rpn->capctes = 0;
+}
@@ -0,0 +1,27 @@
+#ifndef RPN_H
+#define RPN_H
+
+#include "sintatico.h"
+
+/* Emissão (chamada pelo parser, na ordem em que reconhece as coisas):
+   rpn_comeca antes de uma expressão de comando, rpn_num/rpn_var nas folhas,
+   rpn_op depois dos operandos, rpn_termina no fim. Com rpn == NULL todas
+   viram nada e rpn_termina devolve n == 0. */
+void    rpn_comeca(RpnEmissor *em, Rpn *rpn);
+void    rpn_num(RpnEmissor *em, Valor num, Tipo t);
+void    rpn_var(RpnEmissor *em, int var, Tipo t);
+void    rpn_op(RpnEmissor *em, RpnOp op, int pos);   /* RPN_NEG é unário, o resto binário */
+RpnExpr rpn_termina(RpnEmissor *em);
+void    rpn_emissor_libera(RpnEmissor *em);
+
+/* Tipo do resultado da expressão (que tem que ter n > 0) */
+Tipo    rpn_tipo(const Rpn *rpn, RpnExpr e);
+
+/* Avalia (n > 0) com as variáveis em vars e põe o resultado em res. Devolve 1 na
+   divisão inteira por zero (o nó RPN_DIV guarda a posição, mas quem chamou
+   é que decide como avisar), 0 se deu certo. */
+int     rpn_avalia(const Rpn *rpn, RpnExpr e, const Valor *vars, Valor *res);
+
+void    rpn_free(Rpn *rpn);
+
+#endif
@@ -1,287 +1,433 @@
-#include <stdio.h>
-#include <stdlib.h>
-#include <ctype.h>
-#include <string.h>
-#include "lexico.h"
-#include "sintatico.h"
-#include "declaracoes.h" 
-
-/* === Funções Auxiliares do Parser ===
-   Mantivemos estáticas aqui para uso interno.
-*/
-
-static const Token *cur(const Parser *p) {
-    if (!p || !p->toks) return NULL;
-    if (p->i < 0) return NULL;
-    if (p->i >= p->n) return &p->toks[p->n-1];
-    return &p->toks[p->i];
-}
-
-static void advance(Parser *p) {
-    if (!p) return;
-    if (p->i < p->n - 1) p->i++;
-}
-
-static void match(Parser *p, int expected) {
-    const Token *t = cur(p);
-    if (!t) {
-        fprintf(stderr, "0:fim de arquivo nao esperado.\n");
-        exit(EXIT_FAILURE);
-    }
-    if (t->type == expected) {
-        advance(p);
-        return;
-    } else {
-        /* Gestão de erros: mostra linha e o que veio errado */
-        if (t->type == END_FILE) {
-            fprintf(stderr, "%d:fim de arquivo nao esperado.\n", t->line);
-        } else {
-            const char *lex = t->lexeme ? t->lexeme : token_name(t->type);
-            fprintf(stderr, "%d:token nao esperado [%s].\n", t->line, lex);
-        }
-        exit(EXIT_FAILURE);
-    }
-}
-
-/* Sinônimo para match, só pra ficar legível que "esperamos" tal token */
-static void expect(Parser *p, int expected) {
-    match(p, expected);
-}
-
-/* --- Declaração antecipada das funções --- */
-static void programa(Parser *p);
-static void bloco(Parser *p);
-static void comando_composto(Parser *p);
-static void comando(Parser *p);
-static void atribuicao(Parser *p);
-static void comando_condicional(Parser *p);
-static void comando_repetitivo(Parser *p);
-
-/* Funções de Expressões (Matemática e Lógica) */
-static void expressao(Parser *p);
-static void expressao_simples(Parser *p);
-static void termo(Parser *p);
-static void fator(Parser *p);
-static void relacao(Parser *p);
-static void variavel(Parser *p);
-
-/* === Implementação das Regras da Gramática === 
-*/
-
-/* Regra principal: programa começa com 'program', tem nome, e termina com ponto. */
-static void programa(Parser *p) {
-    printf("<programa> ::= program <identificador> ; <bloco> .\n");
-    expect(p, PROGRAM_TOK);
-    expect(p, ID);
-    expect(p, SEMICOLON);
-    bloco(p);
-    expect(p, DOT);
-}
-
-/* O bloco junta as declarações (var) e os comandos (código em si) */
-static void bloco(Parser *p) {
-    parte_de_declaracoes_de_variaveis(p); 
-    comando_composto(p);
-}
-
-/* O famoso bloco begin ... end */
-static void comando_composto(Parser *p) {
-    printf("<comando_composto> ::= begin <comando> ; { <comando> ; } end\n");
-    expect(p, BEGIN_TOK);
-
-    /* Tem que ter ao menos um comando */
-    comando(p);
-    expect(p, SEMICOLON);
-
-    /* Aqui a gente fica rodando enquanto houver novos comandos.
-       Como sabemos que é um comando? Se começar com ID, begin, if ou while.
-    */
-    while (cur(p)->type == ID || cur(p)->type == BEGIN_TOK || 
-           cur(p)->type == IF_TOK || cur(p)->type == WHILE_TOK) {
-        comando(p);
-        expect(p, SEMICOLON);
-    }
-
-    expect(p, END_TOK);
-}
-
-/* Decide qual tipo de comando executar com base no token atual */
-static void comando(Parser *p) {
-    int t = cur(p)->type;
-
-    if (t == ID) {
-        atribuicao(p);        /* Ex: x := 10 */
-    } else if (t == BEGIN_TOK) {
-        comando_composto(p);  /* Ex: begin ... end */
-    } else if (t == IF_TOK) {
-        comando_condicional(p); /* Ex: if ... then */
-    } else if (t == WHILE_TOK) {
-        comando_repetitivo(p);  /* Ex: while ... do */
-    } else {
-        /* Se não for nenhum desses, temos um erro de sintaxe. */
-        const Token *err = cur(p);
-        const char *lex = err->lexeme ? err->lexeme : token_name(err->type);
-        fprintf(stderr, "%d:token nao esperado [%s].\n", err->line, lex);
-        exit(EXIT_FAILURE);
-    }
-}
-
-/* Atribuição: coloca valor numa variável. Ex: a := b + 1 */
-static void atribuicao(Parser *p) {
-    printf("<atribuicao> ::= <variavel> := <expressao>\n");
-    variavel(p);       /* O lado esquerdo (quem recebe) */
-    expect(p, ASSIGN); /* O símbolo := */
-    expressao(p);      /* O lado direito (o valor calculado) */
-}
-
-/* Estrutura IF ... THEN ... [ELSE] */
-static void comando_condicional(Parser *p) {
-    printf("<comando_condicional> ::= if <expressao> then <comando> [else <comando>]\n");
-    expect(p, IF_TOK);
-    expressao(p);      /* A condição */
-    expect(p, THEN_TOK);
-    comando(p);        /* O que fazer se for verdade */
-
-    /* O ELSE é opcional, só entramos aqui se o token atual for 'else' */
-    if (cur(p)->type == ELSE_TOK) {
-        expect(p, ELSE_TOK);
-        comando(p);
-    }
-}
-
-/* Estrutura WHILE ... DO */
-static void comando_repetitivo(Parser *p) {
-    printf("<comando_repetitivo> ::= while <expressao> do <comando>\n");
-    expect(p, WHILE_TOK);
-    expressao(p);      /* Condição de parada */
-    expect(p, DO_TOK);
-    comando(p);        /* O que repetir */
-}
-
-/* === Análise de Expressões ===
-   Aqui a precedência importa (quem é calculado primeiro).
-*/
-
-/* Expressão geral: pode ter comparação (ex: a < b) */
-static void expressao(Parser *p){
-    printf("<expressao> ::= <expressao_simples> [<relacao> <expressao_simples>]\n");
-    expressao_simples(p);
-
-    const Token *t = cur(p);
-    if (!t) return;
-
-    /* Se tiver operador relacional (=, <, >, etc), processa a segunda parte */
-    switch (t->type){
-        case EQ:
-        case NE:
-        case LT:
-        case LE:
-        case GT:
-        case GE:
-            relacao(p);
-            expressao_simples(p);
-            break;
-    }
-}
-
-/* Verifica qual operador de comparação estamos usando */
-static void relacao(Parser *p){
-    printf("<relacao> ::= = | <> | < | <= | >= | >\n");
-    const Token *t = cur(p);
-    
-    switch(t->type){
-        case EQ: match(p, EQ); break;
-        case NE: match(p, NE); break;
-        case LT: match(p, LT); break;
-        case LE: match(p, LE); break;
-        case GT: match(p, GT); break;
-        case GE: match(p, GE); break;
-        default:
-            fprintf(stderr, "%d: operador relacional esperado.\n", t->line);
-            exit(EXIT_FAILURE);
-    }
-}
-
-/* Expressão simples: somas e subtrações */
-static void expressao_simples (Parser *p){
-    printf("<expressao_simples> ::= [+|-] <termo> { (+|-) <termo> }\n");
-    
-    /* Verifica sinal unário opcional no começo (ex: -10 ou +5) */
-    const Token *check = cur(p);
-    if (check && (check->type == PLUS || check->type == MINUS)) {
-        match(p, check->type);
-    }
-
-    termo(p);
-
-    /* Processa cadeias de soma/subtração: a + b - c */
-    const Token *t = cur(p);
-    while (t && (t->type == PLUS || t->type == MINUS)){
-        match(p, t->type);
-        termo(p);
-        t = cur(p);
-    }
-}
-
-/* Termo: multiplicações e divisões (têm precedência sobre soma) */
-static void termo (Parser *p){
-    printf("<termo> ::= <fator> { (*|/) <fator> }\n");
-    fator(p);
-
-    const Token *t = cur(p);
-    while (t && (t->type == MULT || t->type == DIV)){
-        match(p, t->type);
-        fator(p);
-        t = cur(p);
-    }
-}
-
-/* Fator: a unidade básica (número, variável ou expressão entre parênteses) */
-static void fator(Parser *p){
-    printf("<fator> ::= <variavel> | <numero> | (<expressao>)\n");
-    const Token *t = cur(p);
-
-    if (!t){
-        printf("Erro: fator não esperado\n");
-        exit(EXIT_FAILURE);
-    }
-
-    if (t->type == ID){
-        variavel(p); 
-    }
-    else if (t->type == NUM){
-        match(p, NUM);
-    }
-    else if (t->type == LPAREN){
-        /* Se abrir parênteses, resolvemos a expressão interna primeiro */
-        match(p, LPAREN);
-        expressao(p);
-        match(p, RPAREN);
-    }
-    else{
-        fprintf(stderr, "%d:fator invalido [%s]\n",
-        t->line, t->lexeme ? t->lexeme : token_name(t->type));
-        exit(EXIT_FAILURE);
-    }
-}
-
-/* Variável é apenas um identificador neste nível */
-static void variavel(Parser *p) {
-    expect(p, ID);
-}
-
-/* Função principal que dispara o parser */
-void parse_program(const TokenVec *v) {
-    if (!v) return;
-    Parser p;
-    p.toks = v->data;
-    p.i = 0;
-    p.n = v->size;
-
-    if (p.n <= 0) {
-        fprintf(stderr, "0:fim de arquivo nao esperado.\n");
-        exit(EXIT_FAILURE);
-    }
-
-    programa(&p);
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <errno.h>
+#include <string.h>
+#include "lexico.h"
+#include "sintatico.h"
+#include "declaracoes.h" 
+#include "tipos.h"
+#include "rpn.h"
+
+int mostrar_derivacoes = 1;
+
+/* === Funções Auxiliares do Parser ===
+   Mantivemos estáticas aqui para uso interno.
+*/
+
+static const Token *cur(const Parser *p) {
+    if (!p || !p->toks) return NULL;
+    if (p->i < 0) return NULL;
+    if (p->i >= p->n) return &p->toks[p->n-1];
+    return &p->toks[p->i];
+}
+
+static void advance(Parser *p) {
+    if (!p) return;
+    if (p->i < p->n - 1) p->i++;
+}
+
+static void match(Parser *p, int expected) {
+    const Token *t = cur(p);
+    if (!t) {
+        fprintf(stderr, "0:0:fim de arquivo nao esperado.\n");
+        exit(EXIT_FAILURE);
+    }
+    if (t->type == expected) {
+        advance(p);
+        return;
+    } else {
+        /* Gestão de erros: mostra linha e o que veio errado */
+        if (t->type == END_FILE) {
+            fprintf(stderr, "%d:%d:fim de arquivo nao esperado.\n", LINHA_COLUNA(p->prog->fonte, t->pos));
+        } else {
+            const char *lex = t->lexeme ? t->lexeme : token_name(t->type);
+            fprintf(stderr, "%d:%d:token nao esperado [%s].\n", LINHA_COLUNA(p->prog->fonte, t->pos), lex);
+        }
+        exit(EXIT_FAILURE);
+    }
+}
+
+/* Sinônimo para match, só pra ficar legível que "esperamos" tal token */
+static void expect(Parser *p, int expected) {
+    match(p, expected);
+}
+
+/* === Construção da árvore ===
+   Cada regra devolve o pedaço de árvore que reconheceu.
+*/
+
+static void *aloca(size_t n) {
+    void *m = calloc(1, n);
+    if (!m) { perror("calloc"); exit(1); }
+    return m;
+}
+
+static AST *novo_no(ASTKind kind, int pos, AST *left, AST *right) {
+    AST *n = aloca(sizeof(AST));
+    n->kind = kind;
+    n->pos = pos;
+    n->left = left;
+    n->right = right;
+    return n;
+}
+
+static Comando *novo_cmd(CmdKind kind, int pos) {
+    Comando *c = aloca(sizeof(Comando));
+    c->kind = kind;
+    c->pos = pos;
+    return c;
+}
+
+/* --- Declaração antecipada das funções --- */
+static void programa(Parser *p);
+static Comando *bloco(Parser *p);
+static Comando *comando_composto(Parser *p);
+static Comando *comando(Parser *p);
+static Comando *atribuicao(Parser *p);
+static Comando *comando_condicional(Parser *p);
+static Comando *comando_repetitivo(Parser *p);
+
+/* Funções de Expressões (Matemática e Lógica) */
+static AST *expressao(Parser *p);
+static AST *expressao_simples(Parser *p);
+static AST *termo(Parser *p);
+static AST *fator(Parser *p);
+static ASTKind relacao(Parser *p);
+static int variavel(Parser *p);
+
+/* === Implementação das Regras da Gramática === 
+*/
+
+/* Regra principal: programa começa com 'program', tem nome, e termina com ponto. */
+static void programa(Parser *p) {
+    DERIVACAO("<programa> ::= program <identificador> ; <bloco> .\n");
+    expect(p, PROGRAM_TOK);
+    const Token *nome = cur(p);
+    expect(p, ID);
+    p->prog->nome = aloca(strlen(nome->lexeme) + 1);
+    strcpy(p->prog->nome, nome->lexeme);
+    expect(p, SEMICOLON);
+    p->prog->corpo = bloco(p);
+    expect(p, DOT);
+}
+
+/* O bloco junta as declarações (var) e os comandos (código em si) */
+static Comando *bloco(Parser *p) {
+    parte_de_declaracoes_de_variaveis(p); 
+    return comando_composto(p);
+}
+
+/* O famoso bloco begin ... end */
+static Comando *comando_composto(Parser *p) {
+    DERIVACAO("<comando_composto> ::= begin <comando> ; { <comando> ; } end\n");
+    Comando *c = novo_cmd(CMD_COMPOSTO, cur(p)->pos);
+    expect(p, BEGIN_TOK);
+
+    /* Tem que ter ao menos um comando */
+    Comando *ultimo = c->corpo = comando(p);
+    expect(p, SEMICOLON);
+
+    /* Aqui a gente fica rodando enquanto houver novos comandos.
+       Como sabemos que é um comando? Se começar com ID, begin, if ou while.
+    */
+    while (cur(p)->type == ID || cur(p)->type == BEGIN_TOK || 
+           cur(p)->type == IF_TOK || cur(p)->type == WHILE_TOK) {
+        ultimo = ultimo->prox = comando(p);
+        expect(p, SEMICOLON);
+    }
+
+    expect(p, END_TOK);
+    return c;
+}
+
+/* Decide qual tipo de comando executar com base no token atual */
+static Comando *comando(Parser *p) {
+    int t = cur(p)->type;
+
+    if (t == ID) {
+        return atribuicao(p);        /* Ex: x := 10 */
+    } else if (t == BEGIN_TOK) {
+        return comando_composto(p);  /* Ex: begin ... end */
+    } else if (t == IF_TOK) {
+        return comando_condicional(p); /* Ex: if ... then */
+    } else if (t == WHILE_TOK) {
+        return comando_repetitivo(p);  /* Ex: while ... do */
+    } else {
+        /* Se não for nenhum desses, temos um erro de sintaxe. */
+        const Token *err = cur(p);
+        const char *lex = err->lexeme ? err->lexeme : token_name(err->type);
+        fprintf(stderr, "%d:%d:token nao esperado [%s].\n", LINHA_COLUNA(p->prog->fonte, err->pos), lex);
+        exit(EXIT_FAILURE);
+    }
+}
+
+/* Atribuição: coloca valor numa variável. Ex: a := b + 1 */
+static Comando *atribuicao(Parser *p) {
+    DERIVACAO("<atribuicao> ::= <variavel> := <expressao>\n");
+    Comando *c = novo_cmd(CMD_ATRIB, cur(p)->pos);
+    c->var = variavel(p);     /* O lado esquerdo (quem recebe) */
+    expect(p, ASSIGN);        /* O símbolo := */
+    rpn_comeca(&p->rpn, p->com_rpn ? &p->prog->rpn : NULL);
+    c->expr = expressao(p);   /* O lado direito (o valor calculado) */
+    c->rpn = rpn_termina(&p->rpn);
+    return c;
+}
+
+/* Estrutura IF ... THEN ... [ELSE] */
+static Comando *comando_condicional(Parser *p) {
+    DERIVACAO("<comando_condicional> ::= if <expressao> then <comando> [else <comando>]\n");
+    Comando *c = novo_cmd(CMD_IF, cur(p)->pos);
+    expect(p, IF_TOK);
+    rpn_comeca(&p->rpn, p->com_rpn ? &p->prog->rpn : NULL);
+    c->expr = expressao(p);   /* A condição */
+    c->rpn = rpn_termina(&p->rpn);
+    expect(p, THEN_TOK);
+    c->corpo = comando(p);    /* O que fazer se for verdade */
+
+    /* O ELSE é opcional, só entramos aqui se o token atual for 'else' */
+    if (cur(p)->type == ELSE_TOK) {
+        expect(p, ELSE_TOK);
+        c->senao = comando(p);
+    }
+    return c;
+}
+
+/* Estrutura WHILE ... DO */
+static Comando *comando_repetitivo(Parser *p) {
+    DERIVACAO("<comando_repetitivo> ::= while <expressao> do <comando>\n");
+    Comando *c = novo_cmd(CMD_WHILE, cur(p)->pos);
+    expect(p, WHILE_TOK);
+    rpn_comeca(&p->rpn, p->com_rpn ? &p->prog->rpn : NULL);
+    c->expr = expressao(p);   /* Condição de parada */
+    c->rpn = rpn_termina(&p->rpn);
+    expect(p, DO_TOK);
+    c->corpo = comando(p);    /* O que repetir */
+    return c;
+}
+
+/* === Análise de Expressões ===
+   Aqui a precedência importa (quem é calculado primeiro).
+*/
+
+/* Expressão geral: pode ter comparação (ex: a < b) */
+static AST *expressao(Parser *p){
+    DERIVACAO("<expressao> ::= <expressao_simples> [<relacao> <expressao_simples>]\n");
+    AST *e = expressao_simples(p);
+
+    const Token *t = cur(p);
+    if (!t) return e;
+
+    /* Se tiver operador relacional (=, <, >, etc), processa a segunda parte */
+    switch (t->type){
+        case EQ:
+        case NE:
+        case LT:
+        case LE:
+        case GT:
+        case GE: {
+            int pos = t->pos;
+            ASTKind op = relacao(p);
+            e = novo_no(op, pos, e, expressao_simples(p));
+            rpn_op(&p->rpn, RPN_EQ + (op - AST_EQ), pos);
+            break;
+        }
+    }
+    return e;
+}
+
+/* Verifica qual operador de comparação estamos usando */
+static ASTKind relacao(Parser *p){
+    DERIVACAO("<relacao> ::= = | <> | < | <= | >= | >\n");
+    const Token *t = cur(p);
+    
+    switch(t->type){
+        case EQ: match(p, EQ); return AST_EQ;
+        case NE: match(p, NE); return AST_NE;
+        case LT: match(p, LT); return AST_LT;
+        case LE: match(p, LE); return AST_LE;
+        case GT: match(p, GT); return AST_GT;
+        case GE: match(p, GE); return AST_GE;
+        default:
+            fprintf(stderr, "%d:%d: operador relacional esperado.\n", LINHA_COLUNA(p->prog->fonte, t->pos));
+            exit(EXIT_FAILURE);
+    }
+}
+
+/* Expressão simples: somas e subtrações */
+static AST *expressao_simples (Parser *p){
+    DERIVACAO("<expressao_simples> ::= [+|-] <termo> { (+|-) <termo> }\n");
+    
+    /* Verifica sinal unário opcional no começo (ex: -10 ou +5) */
+    const Token *check = cur(p);
+    int negativo = 0, pos = check ? check->pos : -1;
+    if (check && (check->type == PLUS || check->type == MINUS)) {
+        negativo = (check->type == MINUS);
+        match(p, check->type);
+    }
+
+    AST *e = termo(p);
+    if (negativo) {
+        e = novo_no(AST_NEG, pos, e, NULL);
+        rpn_op(&p->rpn, RPN_NEG, pos);
+    }
+
+    /* Processa cadeias de soma/subtração: a + b - c (associa à esquerda) */
+    const Token *t = cur(p);
+    while (t && (t->type == PLUS || t->type == MINUS)){
+        ASTKind op = (t->type == PLUS) ? AST_ADD : AST_SUB;
+        pos = t->pos;
+        match(p, t->type);
+        e = novo_no(op, pos, e, termo(p));
+        rpn_op(&p->rpn, op == AST_ADD ? RPN_ADD : RPN_SUB, pos);
+        t = cur(p);
+    }
+    return e;
+}
+
+/* Termo: multiplicações e divisões (têm precedência sobre soma) */
+static AST *termo (Parser *p){
+    DERIVACAO("<termo> ::= <fator> { (*|/) <fator> }\n");
+    AST *e = fator(p);
+
+    const Token *t = cur(p);
+    while (t && (t->type == MULT || t->type == DIV)){
+        ASTKind op = (t->type == MULT) ? AST_MUL : AST_DIV;
+        int pos = t->pos;
+        match(p, t->type);
+        e = novo_no(op, pos, e, fator(p));
+        rpn_op(&p->rpn, op == AST_MUL ? RPN_MUL : RPN_DIV, pos);
+        t = cur(p);
+    }
+    return e;
+}
+
+/* Fator: a unidade básica (número, variável ou expressão entre parênteses) */
+static AST *fator(Parser *p){
+    DERIVACAO("<fator> ::= <variavel> | <numero> | (<expressao>)\n");
+    const Token *t = cur(p);
+
+    if (!t){
+        printf("Erro: fator não esperado\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (t->type == ID){
+        AST *n = novo_no(AST_VAR, t->pos, NULL, NULL);
+        n->var = variavel(p);
+        rpn_var(&p->rpn, n->var, p->prog->vars[n->var].tipo);
+        return n;
+    }
+    else if (t->type == NUM){
+        AST *n = novo_no(AST_NUM, t->pos, NULL, NULL);
+        /* Literal só com dígitos é integer; com ponto ou expoente é real.
+           O integer sai do texto, não do double do token (que perde os
+           dígitos depois de 2^53). */
+        n->tipo = (strspn(t->lexeme, "0123456789") == strlen(t->lexeme)) ? TIPO_INTEGER : TIPO_REAL;
+        if (n->tipo == TIPO_INTEGER) {
+            errno = 0;
+            n->num.i = strtoll(t->lexeme, NULL, 10);
+            if (errno == ERANGE) {
+                fprintf(stderr, "%d:%d:inteiro fora do intervalo [%s].\n",
+                        LINHA_COLUNA(p->prog->fonte, t->pos), t->lexeme);
+                exit(EXIT_FAILURE);
+            }
+        } else {
+            n->num.f = t->value;
+        }
+        rpn_num(&p->rpn, n->num, n->tipo);
+        match(p, NUM);
+        return n;
+    }
+    else if (t->type == LPAREN){
+        /* Se abrir parênteses, resolvemos a expressão interna primeiro */
+        match(p, LPAREN);
+        AST *e = expressao(p);
+        match(p, RPAREN);
+        return e;
+    }
+    else{
+        fprintf(stderr, "%d:%d:fator invalido [%s]\n",
+        LINHA_COLUNA(p->prog->fonte, t->pos), t->lexeme ? t->lexeme : token_name(t->type));
+        exit(EXIT_FAILURE);
+    }
+}
+
+/* Variável é um identificador que precisa ter sido declarado no 'var'.
+   Devolve o índice dela na tabela. */
+static int variavel(Parser *p) {
+    const Token *t = cur(p);
+    if (t->type == ID) {
+        int idx = busca_variavel(p->prog, t->lexeme);
+        if (idx < 0) {
+            fprintf(stderr, "%d:%d:identificador nao declarado [%s].\n", LINHA_COLUNA(p->prog->fonte, t->pos), t->lexeme);
+            exit(EXIT_FAILURE);
+        }
+        expect(p, ID);
+        return idx;
+    }
+    expect(p, ID); /* Não é ID: deixa o expect reportar o erro */
+    return -1;
+}
+
+/* Função principal que dispara o parser */
+static Programa *parse(const TokenVec *v, int com_rpn) {
+    if (!v) return NULL;
+    Parser p;
+    p.com_rpn = com_rpn;
+    p.toks = v->data;
+    p.i = 0;
+    p.n = v->size;
+    p.rpn.tipos = NULL;
+    p.rpn.captipos = 0;
+
+    if (p.n <= 0) {
+        fprintf(stderr, "0:0:fim de arquivo nao esperado.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    p.prog = aloca(sizeof(Programa));
+    p.prog->fonte = v->fonte;
+    programa(&p);
+    rpn_emissor_libera(&p.rpn);
+    anota_tipos(p.prog);
+    return p.prog;
+}
+
+Programa *parse_program(const TokenVec *v) {
+    return parse(v, 0);
+}
+
+Programa *parse_program_rpn(const TokenVec *v) {
+    return parse(v, 1);
+}
+
+/* === Faxina da árvore === */
+
+void ast_free(AST *t) {
+    if (!t) return;
+    ast_free(t->left);
+    ast_free(t->right);
+    free(t);
+}
+
+static void cmd_free(Comando *c) {
+    while (c) {
+        Comando *prox = c->prox;
+        ast_free(c->expr);
+        cmd_free(c->corpo);
+        cmd_free(c->senao);
+        free(c);
+        c = prox;
+    }
+}
+
+void programa_free(Programa *prog) {
+    if (!prog) return;
+    for (int i = 0; i < prog->nvars; i++) free(prog->vars[i].nome);
+    free(prog->vars);
+    free(prog->nome);
+    cmd_free(prog->corpo);
+    rpn_free(&prog->rpn);
+    free(prog);
 }
\ No newline at end of file
@@ -1,32 +1,144 @@
-#ifndef SINTATICO_H
-#define SINTATICO_H
-
-#include "lexico.h"
-
-
-
-typedef enum {
-    AST_NUM, AST_ADD, AST_SUB, AST_MUL, AST_DIV
-} ASTKind;
-
-typedef struct AST {
-    ASTKind kind;
-    double  num;          
-    struct AST *left;     
-    struct AST *right;    
-} AST;
-
-typedef struct {
-    const Token *toks;
-    int i, n;
-} Parser;
-
-
-void parse_program(const TokenVec *v); 
-
-
-void  ast_print(const AST *t, int depth);
-void  ast_to_dot(const AST *t, const char *path);
-void  ast_free(AST *t);
-
+#ifndef SINTATICO_H
+#define SINTATICO_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "lexico.h"
+
+/* Liga/desliga a impressão das regras da gramática (as linhas "<programa> ::= ...").
+   O modo padrão imprime; os modos de IR/execução desligam pra não poluir a saída. */
+extern int mostrar_derivacoes;
+#define DERIVACAO(...) do { if (mostrar_derivacoes) printf(__VA_ARGS__); } while (0)
+
+/* Tipos aceitos na declaração (var x: integer / real) */
+typedef enum { TIPO_INTEGER, TIPO_REAL } Tipo;
+
+/* Um valor sem etiqueta: quem sabe se é i ou f é o tipo estático */
+typedef union {
+    long long i;
+    double    f;
+} Valor;
+
+typedef enum {
+    AST_NUM, AST_ADD, AST_SUB, AST_MUL, AST_DIV,
+    AST_VAR, AST_NEG,
+    AST_EQ, AST_NE, AST_LT, AST_LE, AST_GT, AST_GE
+} ASTKind;
+
+typedef struct AST {
+    ASTKind kind;
+    Valor   num;          /* AST_NUM: .i se o literal é integer, .f se real */
+    int     var;          /* AST_VAR: índice na tabela de variáveis */
+    Tipo    tipo;         /* tipo estático (preenchido por anota_tipos) */
+    int     pos;          /* byte no fonte (Fonte do programa) */
+    struct AST *left;
+    struct AST *right;
+} AST;
+
+/* -------------------- Expressões em pós-fixa (RPN) --------------------
+   O parser emite cada expressão também num vetor contíguo em ordem
+   pós-fixa (a + b * 2 vira  a b 2 * +), sem ponteiro nenhum: cada nó tem
+   8 bytes e aponta pra variável ou pra constante por índice de 32 bits.
+   O tipo de cada operação já sai decidido na emissão (mesma regra de
+   tipos.h), e conv diz qual operando integer precisa virar real antes.
+   Só é gerado quando alguém pede (parse_program_rpn): a árvore continua
+   sendo a representação principal (tipos, IR, backend C), e quem avalia
+   direto da pós-fixa é o lote (lote.c) e o --bench-expr. */
+
+typedef enum {
+    RPN_NUM, RPN_VAR,
+    RPN_ADD, RPN_SUB, RPN_MUL, RPN_DIV, RPN_NEG,
+    RPN_EQ, RPN_NE, RPN_LT, RPN_LE, RPN_GT, RPN_GE
+} RpnOp;
+
+#define RPN_CONV_A 1   /* alarga pra real o operando de baixo (esquerdo) */
+#define RPN_CONV_B 2   /* alarga pra real o operando do topo (direito) */
+
+typedef struct {
+    uint8_t  op;     /* RpnOp */
+    uint8_t  tipo;   /* tipo em que a operação calcula (relação: dos operandos) */
+    uint8_t  conv;   /* RPN_CONV_* */
+    uint8_t  livre;
+    uint32_t arg;    /* RPN_VAR: variável; RPN_NUM: índice em ctes; RPN_DIV: byte no fonte */
+} RpnNo;
+
+/* Uma expressão: nos[ini .. ini+n-1] do Rpn do programa, que precisa de
+   uma pilha com 'pilha' posições. n == 0 quando o programa foi lido sem RPN. */
+typedef struct {
+    uint32_t ini, n, pilha;
+} RpnExpr;
+
+typedef struct {
+    RpnNo   *nos;  uint32_t nnos, capnos;
+    Valor   *ctes; uint32_t nctes, capctes;
+} Rpn;
+
+/* Pilha que rpn_avalia deixa no quadro da função; expressão mais funda
+   que isso usa uma do heap */
+#define RPN_PILHA 64
+
+/* Estado da emissão: a pilha de tipos imita a pilha da avaliação */
+typedef struct {
+    Rpn     *rpn;      /* NULL = emissão desligada */
+    uint32_t ini;
+    Tipo    *tipos;    /* cresce conforme a expressão mais funda do programa */
+    int      captipos, prof;
+    int      maior;    /* profundidade máxima da expressão atual */
+} RpnEmissor;
+
+typedef struct {
+    char *nome;
+    Tipo  tipo;
+    int   pos;
+} Variavel;
+
+/* Comandos do bloco begin ... end */
+typedef enum {
+    CMD_ATRIB, CMD_COMPOSTO, CMD_IF, CMD_WHILE
+} CmdKind;
+
+typedef struct Comando {
+    CmdKind kind;
+    int     pos;
+    int     var;              /* CMD_ATRIB: variável que recebe o valor */
+    AST    *expr;             /* CMD_ATRIB: valor; CMD_IF/CMD_WHILE: condição */
+    RpnExpr rpn;              /* a mesma expressão em pós-fixa (em Programa.rpn) */
+    struct Comando *corpo;    /* then / corpo do while / primeiro comando do composto */
+    struct Comando *senao;    /* else (pode ser NULL) */
+    struct Comando *prox;     /* próximo comando dentro do composto */
+} Comando;
+
+/* Resultado do parse: nome, variáveis declaradas e o comando composto principal */
+typedef struct {
+    char     *nome;
+    Variavel *vars;
+    int       nvars, capvars;
+    Comando  *corpo;
+    Rpn       rpn;      /* nós pós-fixos das expressões (vazio sem parse_program_rpn) */
+    Fonte    *fonte;    /* pra transformar os pos em linha:coluna (é do TokenVec) */
+} Programa;
+
+typedef struct {
+    const Token *toks;
+    int i, n;
+    Programa *prog;
+    RpnEmissor rpn;
+    int        com_rpn;
+} Parser;
+
+
+Programa *parse_program(const TokenVec *v);
+/* Igual, mas também emite cada expressão de comando em Programa.rpn */
+Programa *parse_program_rpn(const TokenVec *v);
+void      programa_free(Programa *prog);
+
+/* Tabela de variáveis (implementada em declaracoes.c) */
+int  declara_variavel(Parser *p, const Token *t);
+int  busca_variavel(const Programa *prog, const char *nome);
+
+
+void  ast_print(const AST *t, int depth);
+void  ast_to_dot(const AST *t, const char *path);
+void  ast_free(AST *t);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,24 @@
+#ifdef _WIN32
+#include <windows.h>
+#include "tempo.h"
+
+double agora_ns(void) {
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER t;
+    if (freq.QuadPart == 0) QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&t);
+    return (double)t.QuadPart * 1e9 / (double)freq.QuadPart;
+}
+
+#else
+#define _POSIX_C_SOURCE 199309L
+#include <time.h>
+#include "tempo.h"
+
+double agora_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+#endif
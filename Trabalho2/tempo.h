@@ -0,0 +1,8 @@
+#ifndef TEMPO_H
+#define TEMPO_H
+
+/* Relógio monotônico em nanossegundos, pra medir passes e execuções.
+   clock() tem resolução ruim demais (no Windows é de milissegundo). */
+double agora_ns(void);
+
+#endif
@@ -0,0 +1,17 @@
+program collatz;
+var
+    x, passos, par: integer;
+    escala: real;
+begin
+    passos := 0;
+    while x > 1 do
+    begin
+        par := x - (x / 2) * 2;
+        if par = 0 then
+            x := x / 2
+        else
+            x := 3 * x + 1;
+        passos := passos + 1;
+    end;
+    escala := escala * passos + 0.5;
+end.
@@ -0,0 +1,15 @@
+program trunca;
+var
+    r, z: real;
+    c, d, e, f, g: integer;
+begin
+    r := 1e30;
+    c := r;
+    d := 0 - r;
+    z := 0.0;
+    e := z / z;
+    f := 9223372036854775807;
+    z := f;
+    g := z;
+    f := 0 - 3.7;
+end.
\ No newline at end of file
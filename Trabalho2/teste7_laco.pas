@@ -0,0 +1,26 @@
+program laco;
+var
+    i, j, n, s, k: integer;
+    media: real;
+begin
+    n := 100;
+    s := 0;
+    k := 5;
+    k := 7;
+    j := 0;
+    while j < n do
+    begin
+        i := 0;
+        while i < n do
+        begin
+            s := s + i * (j * j + 1);
+            if s > 100000 then
+                s := s - 100000
+            else
+                s := s + 0;
+            i := i + 1;
+        end;
+        j := j + 1;
+    end;
+    media := s / n;
+end.
@@ -0,0 +1,24 @@
+program bench;
+var
+    i, j, n, soma, resto: integer;
+    acc: real;
+begin
+    n := 3000;
+    soma := 0;
+    acc := 0;
+    i := 0;
+    while i < n do
+    begin
+        j := 0;
+        while j < n do
+        begin
+            resto := soma - (soma / 7) * 7;
+            soma := soma + i * j + resto;
+            if soma > 1000000 then
+                soma := soma - 1000000;
+            acc := acc + (i + 1) / (j + 1);
+            j := j + 1;
+        end;
+        i := i + 1;
+    end;
+end.
@@ -0,0 +1,21 @@
+program inteiro;
+var
+    i, j, n, soma, resto: integer;
+begin
+    n := 3000;
+    soma := 0;
+    i := 0;
+    while i < n do
+    begin
+        j := 0;
+        while j < n do
+        begin
+            resto := soma - (soma / 7) * 7;
+            soma := soma + i * j + resto;
+            if soma > 1000000 then
+                soma := soma - 1000000;
+            j := j + 1;
+        end;
+        i := i + 1;
+    end;
+end.
@@ -0,0 +1,47 @@
+#include <stdio.h>
+#include "tipos.h"
+
+Tipo tipo_comum(Tipo a, Tipo b) {
+    return (a == TIPO_INTEGER && b == TIPO_INTEGER) ? TIPO_INTEGER : TIPO_REAL;
+}
+
+const char *nome_tipo(Tipo t) {
+    return t == TIPO_INTEGER ? "integer" : "real";
+}
+
+/* Pós-ordem: primeiro os filhos, depois o nó */
+static void anota_expr(const Programa *prog, AST *e) {
+    switch (e->kind) {
+        case AST_NUM:
+            break; /* o parser já decidiu pelo lexema */
+        case AST_VAR:
+            e->tipo = prog->vars[e->var].tipo;
+            break;
+        case AST_NEG:
+            anota_expr(prog, e->left);
+            e->tipo = e->left->tipo;
+            break;
+        case AST_EQ: case AST_NE: case AST_LT: case AST_LE: case AST_GT: case AST_GE:
+            anota_expr(prog, e->left);
+            anota_expr(prog, e->right);
+            e->tipo = TIPO_INTEGER;
+            break;
+        default:
+            anota_expr(prog, e->left);
+            anota_expr(prog, e->right);
+            e->tipo = tipo_comum(e->left->tipo, e->right->tipo);
+            break;
+    }
+}
+
+static void anota_cmd(const Programa *prog, Comando *c) {
+    for (; c; c = c->prox) {
+        if (c->expr) anota_expr(prog, c->expr);
+        anota_cmd(prog, c->corpo);
+        anota_cmd(prog, c->senao);
+    }
+}
+
+void anota_tipos(Programa *prog) {
+    anota_cmd(prog, prog->corpo);
+}
@@ -0,0 +1,44 @@
+#ifndef TIPOS_H
+#define TIPOS_H
+
+#include <limits.h>
+#include "sintatico.h"
+
+/* -------------------- Tipagem estática --------------------
+   Dá um tipo pra cada nó de expressão a partir das declarações e dos literais:
+     - variável: o tipo declarado; literal: integer se só tem dígitos
+     - + - * e sinal: integer se os dois lados são integer, senão real
+       (o lado integer é alargado pra real implicitamente)
+     - / entre dois integer é divisão inteira (trunca em direção ao zero)
+     - relação (= <> < <= > >=) compara no tipo comum e vale integer 0/1
+   Atribuir real numa variável integer descarta a parte fracionária; o que
+   não cabe em 64 bits satura (ver trunca_real).
+*/
+
+void anota_tipos(Programa *prog);
+
+/* Tipo comum de dois operandos (integer só se os dois forem) */
+Tipo tipo_comum(Tipo a, Tipo b);
+
+const char *nome_tipo(Tipo t);
+
+/* real -> integer, igual em todo lugar (dobra de constantes, interpretador,
+   lote e o mp_trunc do C gerado): corta a parte fracionária, satura fora de
+   [-2^63, 2^63) e NaN vira 0. O cast direto do C é indefinido nesses casos,
+   e cada backend dava um valor diferente. */
+static inline long long trunca_real(double x) {
+    if (x != x) return 0;
+    if (x >= 9223372036854775808.0) return LLONG_MAX;
+    if (x < -9223372036854775808.0) return LLONG_MIN;
+    return (long long)x;
+}
+
+/* Divisão inteira (b != 0, quem chama trata o zero), igual em todo lugar
+   (dobra, interpretador, lote, RPN e o mp_div do C gerado): trunca em
+   direção ao zero, e x / -1 nega em unsigned pra INT64_MIN / -1 dar a volta
+   em vez de derrubar o processo. */
+static inline long long div_inteira(long long a, long long b) {
+    return b == -1 ? (long long)(0 - (unsigned long long)a) : a / b;
+}
+
+#endif